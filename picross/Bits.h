@@ -0,0 +1,64 @@
+#ifndef BITS_H_INCLUDED
+#define BITS_H_INCLUDED
+
+#include <bitset>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace picross {
+	// Returns the position of the lowest set bit, the word can't be 0
+	inline int count_trailing_zeros(uint64_t word) {
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return static_cast<int>(index);
+#elif defined(_MSC_VER)
+		// 32 bit builds can only scan half of the word at a time
+		unsigned long index;
+		if (_BitScanForward(&index, static_cast<unsigned long>(word))) {
+			return static_cast<int>(index);
+		}
+		_BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+		return static_cast<int>(index) + 32;
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	// Returns the number of set bits
+	inline int count_bits(uint64_t word) {
+#ifdef _MSC_VER
+		return static_cast<int>(std::bitset<64>(word).count());
+#else
+		return __builtin_popcountll(word);
+#endif
+	}
+
+	// Reverses the order of the bits in a word, bit 0 becomes bit 63
+	inline uint64_t reverse_word(uint64_t word) {
+		word = ((word >> 1) & 0x5555555555555555ull) | ((word & 0x5555555555555555ull) << 1);
+		word = ((word >> 2) & 0x3333333333333333ull) | ((word & 0x3333333333333333ull) << 2);
+		word = ((word >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((word & 0x0F0F0F0F0F0F0F0Full) << 4);
+		word = ((word >> 8) & 0x00FF00FF00FF00FFull) | ((word & 0x00FF00FF00FF00FFull) << 8);
+		word = ((word >> 16) & 0x0000FFFF0000FFFFull) | ((word & 0x0000FFFF0000FFFFull) << 16);
+		return (word >> 32) | (word << 32);
+	}
+
+	// Transposes a 64x64 block of bits in place, afterwards bit j of word i is what bit i of word j was
+	// The block is split in half and the off diagonal quarters are swapped, then each quarter is split again down to single bits
+	inline void transpose_64(uint64_t block[64]) {
+		uint64_t mask = 0x00000000FFFFFFFFull;
+		for (int width = 32; width != 0; width >>= 1, mask ^= mask << width) {
+			for (int k = 0; k < 64; k = ((k | width) + 1) & ~width) {
+				uint64_t swap = ((block[k] >> width) ^ block[k | width]) & mask;
+				block[k] ^= swap << width;
+				block[k | width] ^= swap;
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
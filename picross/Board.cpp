@@ -1,5 +1,7 @@
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <cmath>
 
 #include "Board.h"
 #include "Functions.h"
@@ -10,54 +12,100 @@ using namespace std;
 using picross::Board;
 
 // Initializes the board
+// The current board and the answer board start completely empty, empty tiles don't take up any memory
 Board::Board() :cur_spaces{ 0 }, correct_spaces{ 0 }, highest_column_count{ 0 }, highest_row_count{ 0 } {
-	width = BOARD_WIDTH;
-	height = BOARD_HEIGHT;
+	resize(BOARD_WIDTH, BOARD_HEIGHT, PUZZLE_COLORS);
+}
 
-	// The cur_spaces and correct_spaces variables are used to check if it is possible that the current board may be correct.
-	// Whenever a space is added, this goes up and once they are equal, it starts checking if they are correct.
-	// Sets the current board and the answer board to be completely empty
-	for (int x = 0; x < width; x++) {
-		for (int y = 0; y < height; y++) {
-			cur_board[x][y] = 0;
-			correct_board[x][y] = 0;
-		}
-	}
+// Changes the size and number of colors of the board, both boards are emptied
+void Board::resize(int new_width, int new_height, int new_colors) {
+	width = new_width;
+	height = new_height;
+
+	cur_board.resize(width, height, new_colors);
+	cur_spaces = 0;
+
+	correct_board.resize(width, height, new_colors);
+	correct_spaces = 0;
+
+	update_nums();
 }
 
 void Board::update(HWND hwnd) {
-	grid.dx = (window_width) / (BOARD_WIDTH + highest_row_count);
-	grid.dy = (window_height) / (BOARD_HEIGHT + highest_column_count);
+	// Fits the whole board and hints to the window, large boards stop shrinking at the minimum size and scroll instead
+	double fit_size = min(floor(window_width / static_cast<double>(width + highest_row_count)), floor(window_height / static_cast<double>(height + highest_column_count)));
+	if (fit_size < MIN_CELL_SIZE) {
+		fit_size = MIN_CELL_SIZE;
+	}
 
 	// Restricts the aspect ratio of the board so that it is 1:1
-	if (grid.dx > grid.dy) {
-		grid.dx = grid.dy;
-	}
-	else {
-		grid.dy = grid.dx;
-	}
+	grid.dx = max(floor(fit_size * grid.zoom), 1.0);
+	grid.dy = grid.dx;
+
+	// The hints only get a portion of the window so that there is always room left for the board
+	grid.hint_columns = min(highest_row_count, static_cast<int>(window_width * MAX_HINT_FRACTION / grid.dx));
+	grid.hint_rows = min(highest_column_count, static_cast<int>(window_height * MAX_HINT_FRACTION / grid.dy));
 
 	// The actual position of the board is in the top left corner of the playing area
-	grid.x = highest_row_count * grid.dx;
-	grid.y = highest_column_count * grid.dy;
+	grid.x = static_cast<int>(grid.hint_columns * grid.dx);
+	grid.y = static_cast<int>(grid.hint_rows * grid.dy);
+
+	grid.visible_columns = max(static_cast<int>(ceil((window_width - grid.x) / grid.dx)), 1);
+	grid.visible_rows = max(static_cast<int>(ceil((window_height - grid.y) / grid.dy)), 1);
+	clamp_scroll();
 
 	// Informs the screen that the entire window needs to be redrawn since the size changed
 	InvalidateRect(hwnd, NULL, false);
 }
 
-// Draws the grid
+void Board::scroll(HWND hwnd, int columns, int rows) {
+	int old_column = grid.first_column;
+	int old_row = grid.first_row;
+
+	grid.first_column += columns;
+	grid.first_row += rows;
+	clamp_scroll();
+
+	if (grid.first_column != old_column || grid.first_row != old_row) {
+		InvalidateRect(hwnd, NULL, false);
+	}
+}
+
+void Board::zoom(HWND hwnd, double factor, POINT anchor) {
+	double new_zoom = min(max(grid.zoom * factor, MIN_ZOOM), MAX_ZOOM);
+	if (new_zoom == grid.zoom) {
+		return;
+	}
+
+	// Remembers which space was under the anchor so that it can be put back under it after the size changes
+	double anchor_column = (anchor.x - grid.x) / grid.dx + grid.first_column;
+	double anchor_row = (anchor.y - grid.y) / grid.dy + grid.first_row;
+
+	grid.zoom = new_zoom;
+	update(hwnd);
+
+	grid.first_column = static_cast<int>(floor(anchor_column - (anchor.x - grid.x) / grid.dx));
+	grid.first_row = static_cast<int>(floor(anchor_row - (anchor.y - grid.y) / grid.dy));
+	clamp_scroll();
+}
+
+#ifdef _WIN32
+// Draws the grid, only the visible part of the board is drawn
 void Board::draw_grid(HDC hdc, COLORREF color) {
 	HBRUSH grid_brush = CreateSolidBrush(color);
 
 	RECT rect = { 0, 0, 0, 0 };
 
-	for (int column = 0; column <= width; column++) {
-		SetRect(&rect, column * grid.dx - 1 + grid.x, grid.y, column * grid.dx + 1 + grid.x, grid.dy * height + grid.y);
+	int columns = end_column() - grid.first_column;
+	int rows = end_row() - grid.first_row;
+
+	for (int column = 0; column <= columns; column++) {
+		SetRect(&rect, column * grid.dx - 1 + grid.x, grid.y, column * grid.dx + 1 + grid.x, grid.dy * rows + grid.y);
 		FillRect(hdc, &rect, grid_brush);
 	}
 
-	for (int row = 0; row <= height; row++) {
-		SetRect(&rect, grid.x, row * grid.dy - 1 + grid.y, grid.dx * width + grid.x, row * grid.dy + 1 + grid.y);
+	for (int row = 0; row <= rows; row++) {
+		SetRect(&rect, grid.x, row * grid.dy - 1 + grid.y, grid.dx * columns + grid.x, row * grid.dy + 1 + grid.y);
 		FillRect(hdc, &rect, grid_brush);
 	}
 
@@ -67,7 +115,7 @@ void Board::draw_grid(HDC hdc, COLORREF color) {
 	DeleteObject(&rect);
 }
 
-// Draws the current board, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer
+// Draws the current board, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer, 4 and up are spaces filled with the other colors
 // x is literally just an x in the Arial font. This causes issues if the board is unrealistically massive in rows and columns
 void Board::draw_board(HDC hdc, COLORREF block_color, COLORREF x_color, COLORREF spacer_color, COLORREF spacer_line_color) {
 	HBRUSH block_brush = CreateSolidBrush(block_color);
@@ -76,27 +124,34 @@ void Board::draw_board(HDC hdc, COLORREF block_color, COLORREF x_color, COLORREF
 	HBRUSH spacer_brush_inner = CreateSolidBrush(BACKGROUND_COLOR);
 	HPEN spacer_pen = CreatePen(PS_SOLID, 1, spacer_line_color);
 
+	// Color 1 uses the block color that was passed in, the other colors come from FILL_COLORS
+	HBRUSH color_brushes[picross::MAX_COLORS] = {};
+	color_brushes[0] = block_brush;
+	for (int color = 2; color <= cur_board.colors; color++) {
+		color_brushes[color - 1] = CreateSolidBrush(FILL_COLORS[color - 1]);
+	}
+
+	// The font is the same for every x so it is only created once per paint
+	HFONT hFont;
+	hFont = CreateFont(static_cast<int>(grid.dy * 0.9), 0, 0, 0, FW_DONTCARE, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_OUTLINE_PRECIS,
+		CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, VARIABLE_PITCH, TEXT("Arial"));
+	HGDIOBJ old_font = SelectObject(hdc, hFont);
+	SetTextColor(hdc, x_color);
+
 	RECT rect = { 0, 0, 0, 0 };
 
-	for (int x = 0; x < width; x++) {
-		for (int y = 0; y < height; y++) {
-			switch (cur_board[x][y])
+	// Only the visible spaces are drawn, x and y are the screen positions of the space relative to the board
+	for (int column = grid.first_column; column < end_column(); column++) {
+		int x = column - grid.first_column;
+		for (int row = grid.first_row; row < end_row(); row++) {
+			int y = row - grid.first_row;
+			int state = cur_board.get(column, row);
+			switch (state)
 			{
-			case 1: {
-				SetRect(&rect, x * grid.dx + grid.x + 1, y * grid.dy + grid.y + 1, (x + 1) * grid.dx + grid.x - 1, (y + 1) * grid.dy + grid.y - 1);
-				FillRect(hdc, &rect, block_brush);
+			case 0:
 				break;
-			}
 			case 2: {
-				HFONT hFont;
-				hFont = CreateFont(static_cast<int>(grid.dy * 0.9), 0, 0, 0, FW_DONTCARE, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_OUTLINE_PRECIS,
-					CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, VARIABLE_PITCH, TEXT("Arial"));
-				SelectObject(hdc, hFont);
-
-				DeleteObject(hFont);
-
 				SetRect(&rect, x * grid.dx + grid.x + 1 + grid.dx / 2, y * grid.dy + grid.y + 1, x * grid.dx + grid.x + 1 + grid.dx / 2, y * grid.dy + grid.y + 1);
-				SetTextColor(hdc, x_color);
 
 				DrawText(hdc, L"x", -1, &rect, DT_NOCLIP);
 				break;
@@ -109,11 +164,24 @@ void Board::draw_board(HDC hdc, COLORREF block_color, COLORREF x_color, COLORREF
 				Ellipse(hdc, x * grid.dx + grid.x + 1 + grid.dx / 3, y * grid.dy + grid.y + 1 + grid.dy / 3, (x + 1) * grid.dx + grid.x - 1 - grid.dx / 3, (y + 1) * grid.dy + grid.y - 1 - grid.dy / 3);
 				break;
 			}
+			// State 1 and every state after the spacer are colors
+			default: {
+				SetRect(&rect, x * grid.dx + grid.x + 1, y * grid.dy + grid.y + 1, (x + 1) * grid.dx + grid.x - 1, (y + 1) * grid.dy + grid.y - 1);
+				FillRect(hdc, &rect, color_brushes[picross::state_color(state) - 1]);
+				break;
+			}
 			}
 		}
 	}
 
-	DeleteObject(block_brush);
+	SelectObject(hdc, old_font);
+	DeleteObject(hFont);
+
+	for (HBRUSH brush : color_brushes) {
+		if (brush != NULL) {
+			DeleteObject(brush);
+		}
+	}
 	DeleteObject(x_brush);
 	DeleteObject(spacer_brush);
 	DeleteObject(spacer_brush_inner);
@@ -123,18 +191,22 @@ void Board::draw_board(HDC hdc, COLORREF block_color, COLORREF x_color, COLORREF
 }
 
 // Draws the number hints in their corresponding places
+// Only the hints for the visible rows and columns are drawn, they stay pinned to the edges of the board as it scrolls
 void Board::draw_num_hints(HDC hdc, COLORREF grid_color) {
 	HBRUSH num_grid_brush = CreateSolidBrush(grid_color);
 
 	RECT rect = { 0, 0, 0, 0 };
 
-	for (int column = 0; column <= width; column++) {
-		SetRect(&rect, column * grid.dx - 1 + grid.x, grid.y - highest_column_count * grid.dy, column * grid.dx + 1 + grid.x, grid.y);
+	int columns = end_column() - grid.first_column;
+	int rows = end_row() - grid.first_row;
+
+	for (int column = 0; column <= columns; column++) {
+		SetRect(&rect, column * grid.dx - 1 + grid.x, grid.y - grid.hint_rows * grid.dy, column * grid.dx + 1 + grid.x, grid.y);
 		FillRect(hdc, &rect, num_grid_brush);
 	}
 
-	for (int row = 0; row <= height; row++) {
-		SetRect(&rect, grid.x - highest_row_count * grid.dx, row * grid.dy - 1 + grid.y, grid.x, row * grid.dy + 1 + grid.y);
+	for (int row = 0; row <= rows; row++) {
+		SetRect(&rect, grid.x - grid.hint_columns * grid.dx, row * grid.dy - 1 + grid.y, grid.x, row * grid.dy + 1 + grid.y);
 		FillRect(hdc, &rect, num_grid_brush);
 	}
 
@@ -143,92 +215,86 @@ void Board::draw_num_hints(HDC hdc, COLORREF grid_color) {
 	HFONT hFont;
 	hFont = CreateFont(static_cast<int>(grid.dy * 0.9), 0, 0, 0, FW_DONTCARE, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_OUTLINE_PRECIS,
 		CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, VARIABLE_PITCH, TEXT("Impact"));
-	SelectObject(hdc, hFont);
+	HGDIOBJ old_font = SelectObject(hdc, hFont);
 
-	DeleteObject(hFont);
+	SetTextColor(hdc, TEXT_COLOR);
+	SetBkColor(hdc, BACKGROUND_COLOR);
 
-	for (int column = 0; column < width; column++) {
+	for (int column = 0; column < columns; column++) {
 		int iterator = 0;
-		for (auto i = column_nums[column].rbegin(); i != column_nums[column].rend(); ++i) {
+		const int* hints = column_nums.begin(grid.first_column + column);
+		const int* colors = column_nums.line_colors(grid.first_column + column);
+		// The hints closest to the board are drawn first so that the ones cut off are the ones farthest away
+		for (int i = column_nums.size(grid.first_column + column) - 1; i >= 0 && iterator < grid.hint_rows; i--) {
 			wchar_t buffer[8];
-			wsprintfW(buffer, L"%d", *i);
+			wsprintfW(buffer, L"%d", hints[i]);
+			SetTextColor(hdc, colors[i] == 1 ? TEXT_COLOR : FILL_COLORS[colors[i] - 1]);
 
 			//Sets the coordinates for the rectangle in which the text is to be formatted.
 			SetRect(&rect, grid.x + grid.dx * column + grid.dx / 2, grid.y - grid.dy * iterator - grid.dy, grid.x + grid.dx * column + grid.dx / 2, grid.y - grid.dy * iterator - grid.dy);
-			SetTextColor(hdc, TEXT_COLOR);
-			SetBkColor(hdc, BACKGROUND_COLOR);
 
 			DrawText(hdc, buffer, -1, &rect, DT_NOCLIP);
-			DeleteObject(buffer);
 			iterator++;
 		}
 	}
 
-	for (int row = 0; row < height; row++) {
+	for (int row = 0; row < rows; row++) {
 		int iterator = 0;
-		for (auto i = row_nums[row].rbegin(); i != row_nums[row].rend(); ++i) {
+		const int* hints = row_nums.begin(grid.first_row + row);
+		const int* colors = row_nums.line_colors(grid.first_row + row);
+		for (int i = row_nums.size(grid.first_row + row) - 1; i >= 0 && iterator < grid.hint_columns; i--) {
 			wchar_t buffer[8];
-			wsprintfW(buffer, L"%d", *i);
+			wsprintfW(buffer, L"%d", hints[i]);
+			SetTextColor(hdc, colors[i] == 1 ? TEXT_COLOR : FILL_COLORS[colors[i] - 1]);
 
 			//Sets the coordinates for the rectangle in which the text is to be formatted.
 			SetRect(&rect, grid.x - grid.dx * iterator - grid.dx / 2, grid.y + grid.dy * row + 1, grid.x - grid.dx * iterator - grid.dx / 2, grid.y + grid.dy * row + grid.dy);
-			SetTextColor(hdc, TEXT_COLOR);
-			SetBkColor(hdc, BACKGROUND_COLOR);
 
 			DrawText(hdc, buffer, -1, &rect, DT_NOCLIP);
-			DeleteObject(buffer);
 			iterator++;
 		}
 	}
 
+	SelectObject(hdc, old_font);
+	DeleteObject(hFont);
+
 	DeleteObject(&rect);
 }
+#endif
 
 // Adds a board to replace the old correct one. If current, it will instead replace the current board
-void Board::add_board(HWND hwnd, int new_board[BOARD_WIDTH][BOARD_HEIGHT], bool current) {
+void Board::add_board(HWND hwnd, const TiledBoard& new_board, bool current) {
 	if (current) {
 		add_board(hwnd, new_board);
-		cur_spaces = 0;
+		cur_board.copy_from(new_board);
+		cur_spaces = cur_board.count_colored();
 	}
 	else {
-		correct_spaces = 0;
-	}
-
-	for (int x = 0; x < width; x++) {
-		for (int y = 0; y < height; y++) {
-			if (current) {
-				cur_board[x][y] = new_board[x][y];
-				if (new_board[x][y] == 1) {
-					cur_spaces++;
-				}
-			}
-			else {
-				correct_board[x][y] = new_board[x][y];
-				if (new_board[x][y] == 1) {
-					correct_spaces++;
-				}
-			}
+		// A board of a different size or number of colors (from a file or a recording) changes the whole board
+		if (new_board.width != width || new_board.height != height || new_board.colors != correct_board.colors) {
+			resize(new_board.width, new_board.height, new_board.colors);
 		}
-	}
 
-	if (!current) {
-		update_column_nums();
-		highest_column_count = get_highest_column_count();
-		update_row_nums();
-		highest_row_count = get_highest_row_count();
+		correct_board.copy_from(new_board);
+		correct_spaces = correct_board.count_colored();
+
+		update_nums();
 		update(hwnd);
 	}
 }
 
-// Updates a position on the board with the state, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer
+// Updates a position on the board with the state, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer, 4 and up are the other colors
+// Every color counts as a filled space for cur_spaces, changing a space from one color to another doesn't change it
 void Board::set_board_space(HWND hwnd, POINT pt, int state) {
-	if (cur_board[pt.x][pt.y] == 1 && state != 1) {
+	bool was_filled = picross::state_color(cur_board.get(pt.x, pt.y)) != 0;
+	bool filled = picross::state_color(state) != 0;
+	if (was_filled && !filled) {
 		cur_spaces--;
 	}
-	if (cur_board[pt.x][pt.y] != 1 && state == 1) {
+	if (!was_filled && filled) {
 		cur_spaces++;
 	}
-	cur_board[pt.x][pt.y] = state;
+	cur_board.set(pt.x, pt.y, state);
 	last_edit = state;
 	invalidate_board_space(hwnd, pt);
 }
@@ -236,38 +302,45 @@ void Board::set_board_space(HWND hwnd, POINT pt, int state) {
 // Indicates that a specific part on the board needs to be redrawn since it was updated
 // This is done for optimization. If it updates the entire screen, elements will flicker as they get redrawn.
 void Board::invalidate_board_space(HWND hwnd, POINT pt) {
+	// Spaces that are scrolled out of view don't need to be redrawn
+	if (pt.x < grid.first_column || pt.x >= end_column() || pt.y < grid.first_row || pt.y >= end_row()) {
+		return;
+	}
+
+	int x = pt.x - grid.first_column;
+	int y = pt.y - grid.first_row;
+
 	RECT rect;
-	SetRect(&rect, pt.x * grid.dx + grid.x + 1, pt.y * grid.dy + grid.y + 1, (pt.x + 1) * grid.dx + grid.x - 1, (pt.y + 1) * grid.dy + grid.y - 1);
+	SetRect(&rect, x * grid.dx + grid.x + 1, y * grid.dy + grid.y + 1, (x + 1) * grid.dx + grid.x - 1, (y + 1) * grid.dy + grid.y - 1);
 	InvalidateRect(hwnd, &rect, false);
 }
 
 // Generates a random board and updates the correct board (and the current board if current is true) with that new board
+// The new board has as many colors as the old one, puzzles with more than one color give each filled space a random color
 void Board::generate_board(HWND hwnd, bool current) {
-	int new_board[BOARD_WIDTH][BOARD_HEIGHT];
+	int colors = correct_board.colors;
+	TiledBoard new_board(width, height, colors);
 
 	for (int x = 0; x < width; x++) {
 		for (int y = 0; y < height; y++) {
 			if (rand_chance(PERCENT_CORRECT)) {
-				new_board[x][y] = 1;
+				int color = colors == 1 ? 1 : random_int() % colors + 1;
+				new_board.set(x, y, picross::color_state(color));
 			}
-
-			cur_board[x][y] = 0;
 		}
 	}
+	cur_board.clear();
 	cur_spaces = 0;
 
 	add_board(hwnd, new_board, current);
 }
 
-// Checks if the current board is equal to the correct board
+// Checks if the current board has the same colors as the correct board
 // Has to update the whole screen if it is correct since a win message is displayed
+// Only the filled spaces matter, so the color planes are compared a word at a time
 bool Board::check_correct(HWND hwnd) {
-	for (int x = 0; x < BOARD_WIDTH; x++) {
-		for (int y = 0; y < BOARD_HEIGHT; y++) {
-			if ((correct_board[x][y] == 1 && cur_board[x][y] != 1) || (correct_board[x][y] != 1 && cur_board[x][y] == 1)) {
-				return false;
-			}
-		}
+	if (!cur_board.colors_equal(correct_board)) {
+		return false;
 	}
 	InvalidateRect(hwnd, NULL, false);
 	return true;
@@ -276,86 +349,44 @@ bool Board::check_correct(HWND hwnd) {
 // Converts a point on the screen to a specific grid space on the board
 POINT Board::point_to_coords(POINT pt) {
 	POINT coords;
-	coords.x = floor((pt.x - grid.x) / grid.dx);
-	coords.y = floor((pt.y - grid.y) / grid.dy);
+	coords.x = static_cast<LONG>(floor((pt.x - grid.x) / grid.dx)) + grid.first_column;
+	coords.y = static_cast<LONG>(floor((pt.y - grid.y) / grid.dy)) + grid.first_row;
 
 	return coords;
 }
 
-// Checks if a point is on the board
+// Checks if a point is on the visible part of the board
 bool Board::pt_on_board(POINT pt) {
-	if (pt.x > grid.x && pt.x < grid.x + grid.dx * width && pt.y > grid.y && pt.y < grid.y + grid.dy * height) {
+	if (pt.x > grid.x && pt.x < grid.x + grid.dx * (end_column() - grid.first_column) && pt.y > grid.y && pt.y < grid.y + grid.dy * (end_row() - grid.first_row)) {
 		return true;
 	}
 	return false;
 }
 
-// Counts up the row spaces and updates the row_nums variable for use in drawing the number hints
-void Board::update_row_nums() {
-
-	int iterator = 0;
-	for (int y = 0; y < height; y++) {
-		row_nums[y].clear();
-		for (int x = 0; x < width; x++) {
-			if (correct_board[x][y] == 1) {
-				iterator++;
-			}
-			else if (iterator != 0) {
-				row_nums[y].push_back(iterator);
-				iterator = 0;
-			}
-		}
-		if (iterator != 0) {
-			row_nums[y].push_back(iterator);
-			iterator = 0;
-		}
-	}
+// Returns the column after the last visible one
+int Board::end_column() {
+	return min(grid.first_column + grid.visible_columns, width);
 }
 
-// Returns the count of the highest number of hints
-int Board::get_highest_row_count() {
-	int count = 0;
-	int size = 0;
-	for (int i = 0; i < BOARD_HEIGHT; i++) {
-		size = row_nums[i].size();
-		if (size > count) {
-			count = size;
-		}
-	}
-	return count;
+// Returns the row after the last visible one
+int Board::end_row() {
+	return min(grid.first_row + grid.visible_rows, height);
 }
 
-// Same as the row updating method
-void Board::update_column_nums() {
+// Keeps the first visible column and row within the board
+// The last column and row can be scrolled to, but not past, so the board never scrolls into empty space
+void Board::clamp_scroll() {
+	int full_columns = max(static_cast<int>((window_width - grid.x) / grid.dx), 1);
+	int full_rows = max(static_cast<int>((window_height - grid.y) / grid.dy), 1);
 
-	int iterator = 0;
-	for (int x = 0; x < width; x++) {
-		column_nums[x].clear();
-		for (int y = 0; y < height; y++) {
-			if (correct_board[x][y] == 1) {
-				iterator++;
-			}
-			else if (iterator != 0) {
-				column_nums[x].push_back(iterator);
-				iterator = 0;
-			}
-		}
-		if (iterator != 0) {
-			column_nums[x].push_back(iterator);
-			iterator = 0;
-		}
-	}
+	grid.first_column = max(min(grid.first_column, width - full_columns), 0);
+	grid.first_row = max(min(grid.first_row, height - full_rows), 0);
 }
 
-// Same as the row count method
-int Board::get_highest_column_count() {
-	int count = 0;
-	int size = 0;
-	for (int i = 0; i < BOARD_WIDTH; i++) {
-		size = column_nums[i].size();
-		if (size > count) {
-			count = size;
-		}
-	}
-	return count;
+// Finds the number hints for every row and column of the correct board and how much space they need
+void Board::update_nums() {
+	extract_color_clues(correct_board, row_nums, column_nums);
+
+	highest_row_count = row_nums.highest_count();
+	highest_column_count = column_nums.highest_count();
 }
\ No newline at end of file
@@ -1,10 +1,16 @@
+#ifndef BOARD_H_INCLUDED
+#define BOARD_H_INCLUDED
+
 #include <vector>
-#include <array>
 
+#include "Clues.h"
 #include "Grid.h"
 #include "Globals.h"
+#include "TiledBoard.h"
 
+using picross::ClueSet;
 using picross::Grid;
+using picross::TiledBoard;
 using namespace std;
 using namespace globals;
 
@@ -17,16 +23,17 @@ namespace picross {
 		int height;
 
 		// The cur_spaces and correct_spaces variables are used to check if it is possible that the current board may be correct.
-		// Whenever a space is added, this goes up and once they are equal, it starts checking if they are correct.
-		int cur_board[BOARD_WIDTH][BOARD_HEIGHT];
+		// Whenever a space is added (of any color), this goes up and once they are equal, it starts checking if they are correct.
+		// The boards are stored in tiles so that large boards only take up memory for the parts that have been used
+		TiledBoard cur_board;
 		int cur_spaces;
 
-		int correct_board[BOARD_WIDTH][BOARD_HEIGHT];
+		TiledBoard correct_board;
 		int correct_spaces;
 
-		// Holds the information for number hints in the columns and rows. They have to be vectors since the size is unknown before hand
-		array<vector<int>, BOARD_WIDTH> column_nums;
-		array<vector<int>, BOARD_HEIGHT> row_nums;
+		// Holds the information for number hints in the columns and rows. Each is one flat array for all of the lines
+		ClueSet column_nums;
+		ClueSet row_nums;
 
 		// Used for changing the size of the grid since more number hints need more space
 		int highest_column_count;
@@ -36,24 +43,38 @@ namespace picross {
 
 		Board();
 
+		// Changes the size and number of colors of the board, both boards are emptied
+		void resize(int new_width, int new_height, int new_colors = 1);
+
 		// Should be run whenever the window size changes so that the board size can be adjusted accordingly
 		// Should also be run if the number hints have changed
 		void update(HWND hwnd);
 
-		// Draws the grid
+		// Moves the visible part of the board by the given number of columns and rows
+		// The scroll is clamped so that the board can't be scrolled past its edges
+		void scroll(HWND hwnd, int columns, int rows);
+
+		// Multiplies the zoom by the factor, keeping the space under the anchor point in the same spot on the screen when possible
+		void zoom(HWND hwnd, double factor, POINT anchor);
+
+		// The drawing methods use GDI, so they only exist on Windows. Other frontends draw the board themselves
+#ifdef _WIN32
+		// Draws the grid, only the visible part of the board is drawn
 		void draw_grid(HDC hdc, COLORREF color);
 
-		// Draws the current board, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer
+		// Draws the current board, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer, 4 and up are spaces filled with the other colors
 		// x is literally just an x in the Arial font. This causes issues if the board is unrealistically massive in rows and columns
 		void draw_board(HDC hdc, COLORREF block_color, COLORREF x_color, COLORREF spacer_color, COLORREF spacer_line_color);
 
-		// Draws the number hints in their corresponding places
+		// Draws the number hints in their corresponding places, each hint is drawn in the color of its spaces
+		// Only the hints for the visible rows and columns are drawn, they stay pinned to the edges of the board as it scrolls
 		void draw_num_hints(HDC hdc, COLORREF grid_color);
+#endif
 
 		// Adds a board to replace the old correct one. If current, it will instead replace the current board
-		void add_board(HWND hwnd, int new_board[BOARD_WIDTH][BOARD_HEIGHT], bool current = false);
+		void add_board(HWND hwnd, const TiledBoard& new_board, bool current = false);
 
-		// Updates a position on the board with the state, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer
+		// Updates a position on the board with the state, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer, 4 and up are the other colors
 		void set_board_space(HWND hwnd, POINT pt, int state);
 
 		// Indicates that a specific part on the board needs to be redrawn since it was updated
@@ -63,27 +84,27 @@ namespace picross {
 		// Generates a random board and updates the correct board (and the current board if current is true) with that new board
 		void generate_board(HWND hwnd, bool current = false);
 
-		// Checks if the current board is equal to the correct board
+		// Checks if the current board has the same colors as the correct board
 		// Has to update the whole screen if it is correct since a win message is displayed
 		bool check_correct(HWND hwnd);
 
 		// Converts a point on the screen to a specific grid space on the board
 		POINT point_to_coords(POINT pt);
 
-		// Checks if a point is on the board
+		// Checks if a point is on the visible part of the board
 		bool pt_on_board(POINT pt);
 
 	private:
-		// Counts up the row spaces and updates the row_nums variable for use in drawing the number hints
-		void update_row_nums();
-
-		// Returns the count of the highest number of hints
-		int get_highest_row_count();
+		// Returns the column and row after the last visible one
+		int end_column();
+		int end_row();
 
-		// Same as the row updating method
-		void update_column_nums();
+		// Keeps the first visible column and row within the board
+		void clamp_scroll();
 
-		// Same as the row count method
-		int get_highest_column_count();
+		// Finds the number hints for every row and column of the correct board and how much space they need
+		void update_nums();
 	};
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
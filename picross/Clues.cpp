@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Bits.h"
+#include "Clues.h"
+
+using namespace std;
+using picross::ClueSet;
+
+// Makes a scratch buffer at least size words long and returns it, buffers only ever grow so reusing one doesn't allocate
+static uint64_t* grow(vector<uint64_t>& buffer, size_t size) {
+	if (buffer.size() < size) {
+		buffer.resize(size);
+	}
+	return buffer.data();
+}
+
+ClueSet::ClueSet() {
+	offsets.push_back(0);
+}
+
+// Removes every line, the memory is kept so that the next extraction doesn't need to allocate
+void ClueSet::clear() {
+	runs.clear();
+	colors.clear();
+	offsets.clear();
+	offsets.push_back(0);
+}
+
+// Finds the runs of set bits in a packed line and adds them as the next line, every run is given the same color
+// A bit differs from the one before it where a run starts or ends, so xoring the line with itself shifted by one
+// leaves a bit set at every run boundary. The boundaries are then read off in pairs with count trailing zeros
+void ClueSet::add_line(const uint64_t* words, int length, int color) {
+	int word_count = (length + TILE_SIZE - 1) / TILE_SIZE;
+	uint64_t carry = 0;
+	int start = 0;
+	bool in_run = false;
+
+	for (int i = 0; i < word_count; i++) {
+		uint64_t word = words[i];
+		uint64_t edges = word ^ ((word << 1) | carry);
+		carry = word >> 63;
+
+		while (edges != 0) {
+			int position = i * TILE_SIZE + count_trailing_zeros(edges);
+			if (in_run) {
+				runs.push_back(position - start);
+				colors.push_back(color);
+			}
+			else {
+				start = position;
+			}
+			in_run = !in_run;
+			edges &= edges - 1;
+		}
+	}
+
+	// A run that reaches the end of the line has no boundary after it
+	if (in_run) {
+		runs.push_back(length - start);
+		colors.push_back(color);
+	}
+	offsets.push_back(static_cast<int>(runs.size()));
+}
+
+// Finds the runs of a line with more than one color and adds them as the next line
+// The boundaries of every color are ored together, so two colors touching still leaves a boundary between them.
+// The color of the run that starts at a boundary is only looked up once for each boundary, not for every space
+void ClueSet::add_color_line(const uint64_t* words, int color_count, int length) {
+	int word_count = (length + TILE_SIZE - 1) / TILE_SIZE;
+	uint64_t carries[MAX_COLORS] = {};
+	int start = 0;
+	int run_color = 0;
+
+	for (int i = 0; i < word_count; i++) {
+		uint64_t edges = 0;
+		uint64_t used = 0;
+		for (int color = 0; color < color_count; color++) {
+			uint64_t word = words[color * word_count + i];
+			edges |= word ^ ((word << 1) | carries[color]);
+			carries[color] = word >> 63;
+			used |= word;
+		}
+
+		while (edges != 0) {
+			int bit = count_trailing_zeros(edges);
+			int position = i * TILE_SIZE + bit;
+			if (run_color != 0) {
+				runs.push_back(position - start);
+				colors.push_back(run_color);
+			}
+
+			run_color = 0;
+			if ((used >> bit) & 1) {
+				while (!((words[run_color * word_count + i] >> bit) & 1)) {
+					run_color++;
+				}
+				run_color++;
+				start = position;
+			}
+			edges &= edges - 1;
+		}
+	}
+
+	if (run_color != 0) {
+		runs.push_back(length - start);
+		colors.push_back(run_color);
+	}
+	offsets.push_back(static_cast<int>(runs.size()));
+}
+
+// Adds a hint to the end of the line being built, end_line finishes the line
+void ClueSet::add_hint(int run, int color) {
+	runs.push_back(run);
+	colors.push_back(color);
+}
+
+void ClueSet::end_line() {
+	offsets.push_back(static_cast<int>(runs.size()));
+}
+
+int ClueSet::line_count() const {
+	return static_cast<int>(offsets.size()) - 1;
+}
+
+int ClueSet::size(int line) const {
+	return offsets[line + 1] - offsets[line];
+}
+
+const int* ClueSet::begin(int line) const {
+	return runs.data() + offsets[line];
+}
+
+const int* ClueSet::end(int line) const {
+	return runs.data() + offsets[line + 1];
+}
+
+// Returns the colors of the hints of a line, in the same order as begin
+const int* ClueSet::line_colors(int line) const {
+	return colors.data() + offsets[line];
+}
+
+// Returns the highest color used by any hint, 0 if there are no hints
+int ClueSet::highest_color() const {
+	int highest = 0;
+	for (int color : colors) {
+		highest = max(highest, color);
+	}
+	return highest;
+}
+
+// Returns the count of the highest number of hints in a line
+int ClueSet::highest_count() const {
+	int count = 0;
+	for (int line = 0; line < line_count(); line++) {
+		count = max(count, size(line));
+	}
+	return count;
+}
+
+// Adds up every hint of a color (every hint if color is 0), this is the number of spaces of that color a board with these hints has
+int ClueSet::total(int color) const {
+	int sum = 0;
+	for (size_t i = 0; i < runs.size(); i++) {
+		if (color == 0 || colors[i] == color) {
+			sum += runs[i];
+		}
+	}
+	return sum;
+}
+
+// Checks if both sets have the same hints for every line
+bool ClueSet::operator==(const ClueSet& other) const {
+	return offsets == other.offsets && runs == other.runs && colors == other.colors;
+}
+
+// Finds the hints for every row and column of a plane of a board
+// Rows are read straight from the tiles, columns come from transposing each tile so they can use the same run finding
+void picross::extract_clues(const TiledBoard& board, int plane, ClueSet& rows, ClueSet& columns, ClueScratch& scratch) {
+	rows.clear();
+	columns.clear();
+	rows.offsets.reserve(board.height + 1);
+	columns.offsets.reserve(board.width + 1);
+
+	uint64_t* line = grow(scratch.line, max(board.tile_columns, board.tile_rows));
+
+	for (int y = 0; y < board.height; y++) {
+		for (int tile_column = 0; tile_column < board.tile_columns; tile_column++) {
+			line[tile_column] = board.row_word(plane, tile_column, y);
+		}
+		rows.add_line(line, board.width);
+	}
+
+	// Every tile in a column of tiles is transposed once, then word c of a transposed tile is column c of that tile
+	uint64_t* blocks = grow(scratch.blocks, static_cast<size_t>(board.tile_rows) * TILE_SIZE);
+
+	for (int tile_column = 0; tile_column < board.tile_columns; tile_column++) {
+		for (int tile_row = 0; tile_row < board.tile_rows; tile_row++) {
+			uint64_t* block = blocks + tile_row * TILE_SIZE;
+			if (board.tile_empty(tile_column, tile_row)) {
+				memset(block, 0, TILE_SIZE * sizeof(uint64_t));
+			}
+			else {
+				memcpy(block, board.tile_plane(plane, tile_column, tile_row), TILE_SIZE * sizeof(uint64_t));
+				transpose_64(block);
+			}
+		}
+
+		int columns_in_tile = min(TILE_SIZE, board.width - tile_column * TILE_SIZE);
+		for (int column = 0; column < columns_in_tile; column++) {
+			for (int tile_row = 0; tile_row < board.tile_rows; tile_row++) {
+				line[tile_row] = blocks[tile_row * TILE_SIZE + column];
+			}
+			columns.add_line(line, board.height);
+		}
+	}
+}
+
+void picross::extract_clues(const TiledBoard& board, int plane, ClueSet& rows, ClueSet& columns) {
+	ClueScratch scratch;
+	extract_clues(board, plane, rows, columns, scratch);
+}
+
+// Finds the hints for every row and column of every color of a board, a board with one color is the same as extract_clues for plane 0
+// Works the same way as extract_clues, but every color plane of a line is gathered (and every color plane of a tile is transposed) together
+void picross::extract_color_clues(const TiledBoard& board, ClueSet& rows, ClueSet& columns, ClueScratch& scratch) {
+	int colors = board.colors;
+	if (colors == 1) {
+		extract_clues(board, 0, rows, columns, scratch);
+		return;
+	}
+
+	rows.clear();
+	columns.clear();
+	rows.offsets.reserve(board.height + 1);
+	columns.offsets.reserve(board.width + 1);
+
+	uint64_t* line = grow(scratch.line, static_cast<size_t>(colors) * max(board.tile_columns, board.tile_rows));
+
+	for (int y = 0; y < board.height; y++) {
+		for (int color = 0; color < colors; color++) {
+			for (int tile_column = 0; tile_column < board.tile_columns; tile_column++) {
+				line[color * board.tile_columns + tile_column] = board.row_word(color_plane(color + 1), tile_column, y);
+			}
+		}
+		rows.add_color_line(line, colors, board.width);
+	}
+
+	// Block b of a color is at blocks[(color * tile_rows + b) * TILE_SIZE]
+	uint64_t* blocks = grow(scratch.blocks, static_cast<size_t>(colors) * board.tile_rows * TILE_SIZE);
+
+	for (int tile_column = 0; tile_column < board.tile_columns; tile_column++) {
+		for (int color = 0; color < colors; color++) {
+			for (int tile_row = 0; tile_row < board.tile_rows; tile_row++) {
+				uint64_t* block = blocks + (color * board.tile_rows + tile_row) * TILE_SIZE;
+				if (board.tile_empty(tile_column, tile_row)) {
+					memset(block, 0, TILE_SIZE * sizeof(uint64_t));
+				}
+				else {
+					memcpy(block, board.tile_plane(color_plane(color + 1), tile_column, tile_row), TILE_SIZE * sizeof(uint64_t));
+					transpose_64(block);
+				}
+			}
+		}
+
+		int columns_in_tile = min(TILE_SIZE, board.width - tile_column * TILE_SIZE);
+		for (int column = 0; column < columns_in_tile; column++) {
+			for (int line_word = 0; line_word < colors * board.tile_rows; line_word++) {
+				line[line_word] = blocks[line_word * TILE_SIZE + column];
+			}
+			columns.add_color_line(line, colors, board.height);
+		}
+	}
+}
+
+void picross::extract_color_clues(const TiledBoard& board, ClueSet& rows, ClueSet& columns) {
+	ClueScratch scratch;
+	extract_color_clues(board, rows, columns, scratch);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef CLUES_H_INCLUDED
+#define CLUES_H_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "TiledBoard.h"
+
+namespace picross {
+	// Holds the number hints for every row or every column in one flat array instead of a vector for each line
+	// The hints for line i are runs[offsets[i]] up to runs[offsets[i + 1]], from the start of the line to the end
+	// colors has the color of each hint in the same place as its run, every hint of a board with one color is color 1
+	class ClueSet {
+	public:
+		std::vector<int> runs;
+		std::vector<int> colors;
+		std::vector<int> offsets;
+
+		ClueSet();
+
+		// Removes every line, the memory is kept so that the next extraction doesn't need to allocate
+		void clear();
+
+		// Finds the runs of set bits in a packed line and adds them as the next line, every run is given the same color
+		// Bit i of words[i / 64] is space i, bits past the length have to be 0
+		void add_line(const uint64_t* words, int length, int color = 1);
+
+		// Finds the runs of a line with more than one color and adds them as the next line
+		// words holds a packed line for each color one after another, each (length + 63) / 64 words long, starting with color 1
+		// Runs of different colors can touch, so a run ends wherever any of the colors changes
+		void add_color_line(const uint64_t* words, int color_count, int length);
+
+		// Adds a hint to the end of the line being built, end_line finishes the line
+		// This is for hints that are read in rather than found from a board
+		void add_hint(int run, int color = 1);
+		void end_line();
+
+		// The number of lines
+		int line_count() const;
+
+		// The number of hints in a line
+		int size(int line) const;
+
+		// Returns the hints of a line
+		const int* begin(int line) const;
+		const int* end(int line) const;
+
+		// Returns the colors of the hints of a line, in the same order as begin
+		const int* line_colors(int line) const;
+
+		// Returns the highest color used by any hint, 0 if there are no hints
+		int highest_color() const;
+
+		// Returns the count of the highest number of hints in a line
+		int highest_count() const;
+
+		// Adds up every hint of a color (every hint if color is 0), this is the number of spaces of that color a board with these hints has
+		int total(int color = 0) const;
+
+		// Checks if both sets have the same hints for every line
+		bool operator==(const ClueSet& other) const;
+	};
+
+	// Buffers that extracting hints works in, callers that extract often keep one so that extracting doesn't allocate
+	// once the buffers have grown to fit the largest board
+	struct ClueScratch {
+		std::vector<uint64_t> line;
+		std::vector<uint64_t> blocks;
+	};
+
+	// Finds the hints for every row and column of a plane of a board
+	// Rows are read straight from the tiles, columns come from transposing each tile so they can use the same run finding
+	void extract_clues(const TiledBoard& board, int plane, ClueSet& rows, ClueSet& columns, ClueScratch& scratch);
+	void extract_clues(const TiledBoard& board, int plane, ClueSet& rows, ClueSet& columns);
+
+	// Finds the hints for every row and column of every color of a board, a board with one color is the same as extract_clues for plane 0
+	void extract_color_clues(const TiledBoard& board, ClueSet& rows, ClueSet& columns, ClueScratch& scratch);
+	void extract_color_clues(const TiledBoard& board, ClueSet& rows, ClueSet& columns);
+}
+
+#endif
\ No newline at end of file
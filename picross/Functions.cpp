@@ -1,8 +1,39 @@
 #include "Functions.h"
 
-#include <windows.h>
+#include <cmath>
 #include <iostream>
 
+// The state of the random number generator, it changes every time a number is generated
+static uint64_t random_state = 0;
+
+// Starts the random number generator from a seed
+void seed_random(uint64_t seed) {
+	random_state = seed;
+}
+
+// The state can be saved and restored to continue generating the exact same numbers later
+uint64_t get_random_state() {
+	return random_state;
+}
+
+void set_random_state(uint64_t state) {
+	random_state = state;
+}
+
+// Returns a random number using splitmix64, which is fast and gives the same numbers on every compiler
+uint32_t random_int() {
+	return random_int(random_state);
+}
+
+// Generates a number from a separate state, for code that runs on more than one thread at once
+uint32_t random_int(uint64_t& state) {
+	state += 0x9E3779B97F4A7C15ull;
+	uint64_t z = state;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+}
+
 // Returns true or false based on the percent (as a decimal). Accurate to 6 decimal places.
 bool rand_chance(double percent) {
 	// Skips any processing if the percent is equal to or above 100%
@@ -26,7 +57,7 @@ bool rand_chance(double percent) {
 
 	int decimal_range = pow(10, num_decimals);
 
-	bool result = rand() % decimal_range < percent* decimal_range;
+	bool result = random_int() % decimal_range < percent* decimal_range;
 
 	return result;
 }
\ No newline at end of file
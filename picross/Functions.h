@@ -1,6 +1,18 @@
 #ifndef FUNCTIONS_H_INCLUDED
 #define FUNCTIONS_H_INCLUDED
 
+#include <cstdint>
+
+// The random number generator is part of the program instead of using rand() so that a seed makes the same puzzles on every platform
+// This lets recorded sessions be replayed exactly anywhere
+void seed_random(uint64_t seed);
+uint64_t get_random_state();
+void set_random_state(uint64_t state);
+uint32_t random_int();
+
+// Generates a number from a separate state, for code that runs on more than one thread at once
+uint32_t random_int(uint64_t& state);
+
 bool rand_chance(double percent);
 
 #endif
\ No newline at end of file
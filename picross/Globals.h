@@ -1,7 +1,7 @@
 #if !defined(GLOBALS_H)
 #define GLOBALS_H 1
 
-#include <windows.h>
+#include "Platform.h"
 
 namespace globals
 {
@@ -18,6 +18,10 @@ namespace globals
 	// it is used solely for holding a button and dragging the mouse so that the user doesn't have to click every space
 	inline int last_edit = 0;
 
+	// The part of the mouse wheel's movement (in WHEEL_DELTA units times WHEEL_SCROLL_SPACES) that hasn't scrolled a whole space yet
+	inline int vertical_wheel_remainder = 0;
+	inline int horizontal_wheel_remainder = 0;
+
 	// Board width and height indicate the grid of the picross board, higher numbers make for a harder puzzle
 	inline const int BOARD_WIDTH = 5;
 	inline const int BOARD_HEIGHT = 5;
@@ -29,6 +33,28 @@ namespace globals
 	inline const double GRID_DX = window_width / BOARD_WIDTH;
 	inline const double GRID_DY = window_height / BOARD_HEIGHT;
 
+	// The smallest size (in pixels) a grid space will shrink to when fitting the board to the window
+	// Boards that would need smaller spaces than this scroll instead, which keeps large boards readable
+	inline const int MIN_CELL_SIZE = 16;
+
+	// Limits for zooming in and out and how much a single zoom step (mouse wheel or +/- key) changes the zoom
+	inline const double MIN_ZOOM = 0.25;
+	inline const double MAX_ZOOM = 8;
+	inline const double ZOOM_STEP = 1.25;
+
+	// How many spaces a single step of the mouse wheel scrolls the board
+	inline const int WHEEL_SCROLL_SPACES = 3;
+
+	// The largest part of the window (as a decimal) that the number hints can take up
+	// If a row or column has more hints than this, the hints farthest from the board are cut off
+	inline const double MAX_HINT_FRACTION = 0.4;
+
+	// The number of colors puzzles start with, 1 makes the usual black and white puzzles. New puzzles keep the number of colors of the last one
+	inline const int PUZZLE_COLORS = 1;
+
+	// The color that left clicks fill spaces with, the number keys change it
+	inline int current_color = 1;
+
 	// The percentage (as a decimal) for how many correct spaces there should be. 
 	// This is a random chance so it can vary. It is accurate to 6 decimal places
 	inline const double PERCENT_CORRECT = 0.6;
@@ -43,6 +69,15 @@ namespace globals
 	inline const COLORREF SPACER_LINE_COLOR = RGB(150, 150, 150);
 	inline const COLORREF NUM_GRID_LINE_COLOR = RGB(100, 100, 100);
 
+	// The colors spaces can be filled with, color 1 is the usual filled space. Hints are drawn in the color of their spaces
+	inline const COLORREF FILL_COLORS[] = { SPACE_COLOR, RGB(220, 50, 47), RGB(38, 139, 210), RGB(133, 153, 0), RGB(211, 54, 130), RGB(181, 137, 0),
+		RGB(42, 161, 152), RGB(108, 113, 196) };
+
+	// Colors only used by the terminal, which can't draw grid lines so every other 5x5 block is shaded instead
+	inline const COLORREF BLOCK_SHADE_COLOR = RGB(228, 228, 228);
+	inline const COLORREF CURSOR_COLOR = RGB(255, 215, 95);
+	inline const COLORREF COUNT_COLOR = RGB(135, 175, 255);
+
 	// Random puzzles relies on the time to create a seed, if it is off, the puzzles will start with a set seed
 	inline const bool RANDOM_PUZZLES = true;
 	// Starts with all the correct spaces filled in if this is true
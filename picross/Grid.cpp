@@ -9,4 +9,13 @@ Grid::Grid() {
 	y = GRID_Y;
 	dx = GRID_DX;
 	dy = GRID_DY;
+
+	zoom = 1;
+
+	first_column = 0;
+	first_row = 0;
+	visible_columns = BOARD_WIDTH;
+	visible_rows = BOARD_HEIGHT;
+	hint_columns = 0;
+	hint_rows = 0;
 }
\ No newline at end of file
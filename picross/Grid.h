@@ -1,3 +1,6 @@
+#ifndef GRID_H_INCLUDED
+#define GRID_H_INCLUDED
+
 #include "Globals.h"
 
 namespace picross {
@@ -8,6 +11,24 @@ namespace picross {
 			int y;
 			double dx;
 			double dy;
+
+			// The zoom multiplies the size of each grid space, 1 is the default size
+			double zoom;
+
+			// The first column and row of the board that are visible, scrolling the board changes these
+			int first_column;
+			int first_row;
+
+			// How many columns and rows of the board fit on the screen, this includes a partially visible space at the edge
+			int visible_columns;
+			int visible_rows;
+
+			// How many number hints fit to the left of and above the board, hints past this are cut off
+			int hint_columns;
+			int hint_rows;
+
 			Grid();
 	};
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
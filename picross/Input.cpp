@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Board.h"
+#include "Globals.h"
+#include "Input.h"
+
+using namespace globals;
+using namespace std;
+
+using picross::Board;
+
+Board board;
+
+// This function handles any click related actions by the user. If the user is holding a click button and dragging, mouse_moving is true
+// Left clicking adds or removes a space or an x
+// Right clicking adds or removes an x or a space
+// Shift clicking adds a spacer
+// Both left and right click will directly override a spacer with the corresponding element
+// Clicking and dragging will add or remove the corresponding space to each grid hovered over
+// If the space was removed, it will remove all elements on dragging, x's do not override spaces, spaces don't override x's, spacers will be overridden
+void handle_click(HWND hwnd, WPARAM wParam, LPARAM lParam, bool mouse_moving) {
+	if (game_over && !mouse_moving) {
+		// Create a new board since the user clicked on the game over screen
+		board.generate_board(hwnd, SHOW_ANSWER);
+		game_over = false;
+	}
+	else {
+		POINT pt;
+		pt.x = LOWORD(lParam);
+		pt.y = HIWORD(lParam);
+
+		if (board.pt_on_board(pt)) {
+			click_space(hwnd, board.point_to_coords(pt), wParam, mouse_moving);
+		}
+	}
+}
+
+// Adds a wheel delta to the remainder and returns how many whole spaces it scrolls, the rest stays in the remainder
+static int wheel_spaces(int& remainder, int delta) {
+	remainder += delta * WHEEL_SCROLL_SPACES;
+	int spaces = remainder / WHEEL_DELTA;
+	remainder -= spaces * WHEEL_DELTA;
+	return spaces;
+}
+
+// Changes a space on the board the way clicking it with the buttons in wParam would, see handle_click for what each click does
+// Frontends that already know which space was clicked (like the terminal) use this directly
+// Left clicks fill with the current color. Left clicking a space of another color changes it to the current color instead of removing it
+void click_space(HWND hwnd, POINT coords, WPARAM wParam, bool mouse_moving) {
+	bool shiftClick = wParam == MK_LBUTTON + MK_SHIFT || wParam == MK_RBUTTON + MK_SHIFT;
+	bool lClick = wParam == MK_LBUTTON && !shiftClick;
+	bool rClick = wParam == MK_RBUTTON && !shiftClick;
+
+	int fill_state = picross::color_state(min(current_color, board.correct_board.colors));
+	int state = board.cur_board.get(coords.x, coords.y);
+
+	switch (state) {
+	case 0:
+		if (mouse_moving) {
+			board.set_board_space(hwnd, coords, last_edit);
+		}
+		else {
+			if (lClick) {
+				board.set_board_space(hwnd, coords, fill_state);
+			}
+			else if (rClick) {
+				board.set_board_space(hwnd, coords, 2);
+			}
+			else if (shiftClick) {
+				board.set_board_space(hwnd, coords, 3);
+			}
+		}
+		break;
+
+	case 2: 
+		if (mouse_moving) {
+			if (last_edit == 0) {
+				board.set_board_space(hwnd, coords, last_edit);
+			}
+		}
+		else {
+			if (lClick || rClick) {
+				board.set_board_space(hwnd, coords, 0);
+			}
+		}
+		break;
+	
+	case 3: 
+		if (mouse_moving) {
+			if (last_edit != 3) {
+				board.set_board_space(hwnd, coords, last_edit);
+			}
+		}
+		else {
+			if (lClick) {
+				board.set_board_space(hwnd, coords, fill_state);
+			}
+			else if (rClick) {
+				board.set_board_space(hwnd, coords, 2);
+			}
+			else if (shiftClick) {
+				board.set_board_space(hwnd, coords, 0);
+			}
+		}
+		break;
+
+	// State 1 and every state after the spacer are colors
+	default:
+		if (mouse_moving) {
+			if (last_edit == 0) {
+				board.set_board_space(hwnd, coords, last_edit);
+			}
+		}
+		else {
+			if (lClick && state != fill_state) {
+				board.set_board_space(hwnd, coords, fill_state);
+			}
+			else if (lClick || rClick) {
+				board.set_board_space(hwnd, coords, 0);
+			}
+		}
+		break;
+	}
+
+	if (board.cur_spaces == board.correct_spaces) {
+		game_over = board.check_correct(hwnd);
+	}
+}
+
+// Checks if a message is one of the user inputs that handle_input deals with, these are the messages that get recorded
+bool is_input_message(UINT uMsg) {
+	switch (uMsg) {
+	case WM_LBUTTONDOWN:
+	case WM_RBUTTONDOWN:
+	case WM_MOUSEMOVE:
+	case WM_KEYDOWN:
+	case WM_MOUSEWHEEL:
+	case WM_MOUSEHWHEEL:
+	case WM_SIZE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Handles a user input message the same way on every platform, mouse positions have to be in the window's coordinates
+// Returns true if the window should be painted right away
+bool handle_input(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
+	switch (uMsg)
+	{
+	case WM_LBUTTONDOWN:
+		handle_click(hwnd, wParam, lParam);
+		return true;
+
+	case WM_RBUTTONDOWN:
+		handle_click(hwnd, wParam, lParam);
+		return true;
+
+	case WM_KEYDOWN: 
+		// 0x52 is the R key
+		// Resets the board, since this program isn't smart enough to tell if a board is completable, I have increased the amount of correct spaces
+		// Increasing the spaces has made it much easier but the majority of games should be completable, however, if necessary the user can reset it
+		if (wParam == 0x52) {
+			board.generate_board(hwnd, SHOW_ANSWER);
+		}
+
+		// The number keys pick the color that left clicks fill with, only the colors the puzzle has can be picked
+		if (wParam >= '1' && wParam <= '9' && static_cast<int>(wParam - '0') <= board.correct_board.colors) {
+			current_color = static_cast<int>(wParam - '0');
+		}
+
+		// The arrow keys scroll the board a space at a time, page up and page down scroll a whole screen of rows
+		// Plus and minus zoom in and out around the top left corner of the board
+		switch (wParam) {
+		case VK_LEFT:
+			board.scroll(hwnd, -1, 0);
+			break;
+		case VK_RIGHT:
+			board.scroll(hwnd, 1, 0);
+			break;
+		case VK_UP:
+			board.scroll(hwnd, 0, -1);
+			break;
+		case VK_DOWN:
+			board.scroll(hwnd, 0, 1);
+			break;
+		case VK_PRIOR:
+			board.scroll(hwnd, 0, -board.grid.visible_rows);
+			break;
+		case VK_NEXT:
+			board.scroll(hwnd, 0, board.grid.visible_rows);
+			break;
+		case VK_ADD:
+		case VK_OEM_PLUS:
+			board.zoom(hwnd, ZOOM_STEP, POINT{ board.grid.x, board.grid.y });
+			break;
+		case VK_SUBTRACT:
+		case VK_OEM_MINUS:
+			board.zoom(hwnd, 1 / ZOOM_STEP, POINT{ board.grid.x, board.grid.y });
+			break;
+		}
+		return false;
+
+	// The mouse wheel scrolls the board up and down, holding shift scrolls left and right instead
+	// Holding control while using the mouse wheel zooms in and out around the mouse
+	// Touchpads and smooth wheels send less than a whole WHEEL_DELTA at a time, so zooming uses the fraction of a step
+	// and scrolling keeps the part that didn't add up to a whole space for the next message
+	case WM_MOUSEWHEEL: {
+		int delta = GET_WHEEL_DELTA_WPARAM(wParam);
+		WORD keys = GET_KEYSTATE_WPARAM(wParam);
+
+		if (keys & MK_CONTROL) {
+			POINT pt;
+			pt.x = GET_X_LPARAM(lParam);
+			pt.y = GET_Y_LPARAM(lParam);
+			board.zoom(hwnd, pow(ZOOM_STEP, static_cast<double>(delta) / WHEEL_DELTA), pt);
+		}
+		else if (keys & MK_SHIFT) {
+			board.scroll(hwnd, wheel_spaces(horizontal_wheel_remainder, -delta), 0);
+		}
+		else {
+			board.scroll(hwnd, 0, wheel_spaces(vertical_wheel_remainder, -delta));
+		}
+		return false;
+	}
+
+	case WM_MOUSEHWHEEL:
+		board.scroll(hwnd, wheel_spaces(horizontal_wheel_remainder, GET_WHEEL_DELTA_WPARAM(wParam)), 0);
+		return false;
+
+	// Used to handle mouse dragging
+	case WM_MOUSEMOVE: 
+		if (wParam == MK_LBUTTON || wParam == MK_RBUTTON || wParam == MK_LBUTTON + MK_SHIFT || wParam == MK_RBUTTON + MK_SHIFT) {
+			POINT pt; 
+			pt.x = LOWORD(lParam);
+			pt.y = HIWORD(lParam);
+			if (board.pt_on_board(pt)) {
+				handle_click(hwnd, wParam, lParam, true);
+				return true;
+			}
+		}
+		return false;
+
+	case WM_SIZE:
+		window_width = LOWORD(lParam);
+		window_height = HIWORD(lParam);
+
+		board.update(hwnd);
+		return true;
+
+	default:
+		return false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef INPUT_H_INCLUDED
+#define INPUT_H_INCLUDED
+
+#include "Board.h"
+#include "Globals.h"
+
+// The board being played, it is shared by every frontend and the replayer
+extern picross::Board board;
+
+// Handles any click related actions by the user. If the user is holding a click button and dragging, mouse_moving is true
+void handle_click(HWND hwnd, WPARAM wParam, LPARAM lParam, bool mouse_moving = false);
+
+// Changes a space on the board the way clicking it with the buttons in wParam would
+void click_space(HWND hwnd, POINT coords, WPARAM wParam, bool mouse_moving = false);
+
+// Checks if a message is one of the user inputs that handle_input deals with, these are the messages that get recorded
+bool is_input_message(UINT uMsg);
+
+// Handles a user input message the same way on every platform, mouse positions have to be in the window's coordinates
+// Returns true if the window should be painted right away
+bool handle_input(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef PLATFORM_H_INCLUDED
+#define PLATFORM_H_INCLUDED
+
+// The game logic only needs a few types and message values from windows.h
+// On other platforms (the headless replayer and other frontends) they are defined here with the same values as Windows,
+// so that recorded input traces mean the same thing everywhere
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <windowsx.h>
+
+#else
+
+#include <cstddef>
+#include <cstdint>
+
+typedef void* HWND;
+typedef unsigned int UINT;
+typedef unsigned short WORD;
+typedef long LONG;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef uint32_t COLORREF;
+
+struct POINT {
+	LONG x;
+	LONG y;
+};
+
+struct RECT {
+	LONG left;
+	LONG top;
+	LONG right;
+	LONG bottom;
+};
+
+#define RGB(r, g, b) ((COLORREF)(((uint8_t)(r)) | ((uint16_t)((uint8_t)(g)) << 8) | (((uint32_t)(uint8_t)(b)) << 16)))
+#define GetRValue(color) ((uint8_t)(color))
+#define GetGValue(color) ((uint8_t)((color) >> 8))
+#define GetBValue(color) ((uint8_t)((color) >> 16))
+
+#define LOWORD(l) ((WORD)(((uintptr_t)(l)) & 0xffff))
+#define HIWORD(l) ((WORD)((((uintptr_t)(l)) >> 16) & 0xffff))
+#define MAKELPARAM(l, h) ((LPARAM)(uint32_t)(((uint16_t)(l)) | ((uint32_t)((uint16_t)(h))) << 16))
+#define GET_X_LPARAM(l) ((int)(short)LOWORD(l))
+#define GET_Y_LPARAM(l) ((int)(short)HIWORD(l))
+#define GET_WHEEL_DELTA_WPARAM(w) ((short)HIWORD(w))
+#define GET_KEYSTATE_WPARAM(w) (LOWORD(w))
+
+const int WHEEL_DELTA = 120;
+
+const UINT WM_SIZE = 0x0005;
+const UINT WM_KEYDOWN = 0x0100;
+const UINT WM_MOUSEMOVE = 0x0200;
+const UINT WM_LBUTTONDOWN = 0x0201;
+const UINT WM_RBUTTONDOWN = 0x0204;
+const UINT WM_MOUSEWHEEL = 0x020A;
+const UINT WM_MOUSEHWHEEL = 0x020E;
+
+const WPARAM MK_LBUTTON = 0x0001;
+const WPARAM MK_RBUTTON = 0x0002;
+const WPARAM MK_SHIFT = 0x0004;
+const WPARAM MK_CONTROL = 0x0008;
+
+const WPARAM VK_ESCAPE = 0x1B;
+const WPARAM VK_PRIOR = 0x21;
+const WPARAM VK_NEXT = 0x22;
+const WPARAM VK_LEFT = 0x25;
+const WPARAM VK_UP = 0x26;
+const WPARAM VK_RIGHT = 0x27;
+const WPARAM VK_DOWN = 0x28;
+const WPARAM VK_ADD = 0x6B;
+const WPARAM VK_SUBTRACT = 0x6D;
+const WPARAM VK_OEM_PLUS = 0xBB;
+const WPARAM VK_OEM_MINUS = 0xBD;
+
+// There is no window to redraw without Windows, so invalidating part of it does nothing
+inline int InvalidateRect(HWND, const RECT*, bool) {
+	return 1;
+}
+
+inline int SetRect(RECT* rect, int left, int top, int right, int bottom) {
+	rect->left = left;
+	rect->top = top;
+	rect->right = right;
+	rect->bottom = bottom;
+	return 1;
+}
+
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Bits.h"
+#include "Globals.h"
+#include "Functions.h"
+#include "Protocol.h"
+
+using namespace std;
+using picross::ClueSet;
+using picross::RequestContext;
+using picross::RequestKind;
+using picross::TiledBoard;
+using picross::Token;
+
+const char* const picross::REQUEST_NAMES[picross::REQUEST_KINDS] = { "verify", "solve", "unique", "generate", "stats", "invalid" };
+
+namespace {
+	bool token_is(Token token, const char* text) {
+		return token.length == strlen(text) && memcmp(token.text, text, token.length) == 0;
+	}
+
+	// Numbers are written into a buffer on the stack so that adding them to a response doesn't make a temporary string
+	void append_int(string& out, long long value) {
+		char buffer[24];
+		int length = snprintf(buffer, sizeof(buffer), "%lld", value);
+		out.append(buffer, length);
+	}
+
+	RequestKind fail(string& response, const char* message) {
+		response.append(" ERROR ");
+		response.append(message);
+		return picross::REQUEST_INVALID;
+	}
+
+	bool parse_size(Token width_token, Token height_token, int& width, int& height) {
+		return picross::parse_int(width_token, width) && picross::parse_int(height_token, height)
+			&& width > 0 && height > 0 && width <= picross::MAX_BOARD_SIDE && height <= picross::MAX_BOARD_SIDE;
+	}
+
+	bool parse_percent(Token token, double& percent) {
+		char buffer[32];
+		if (token.length == 0 || token.length >= sizeof(buffer)) {
+			return false;
+		}
+		memcpy(buffer, token.text, token.length);
+		buffer[token.length] = '\0';
+		char* end;
+		percent = strtod(buffer, &end);
+		return *end == '\0' && percent >= 0 && percent <= 1;
+	}
+}
+
+// Splits a line at spaces, returns the number of tokens. Tokens past max_tokens are counted but not stored
+int picross::split_tokens(const char* line, size_t length, Token* tokens, int max_tokens) {
+	int count = 0;
+	size_t i = 0;
+	while (i < length) {
+		while (i < length && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+			i++;
+		}
+		if (i == length) {
+			break;
+		}
+		size_t start = i;
+		while (i < length && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+			i++;
+		}
+		if (count < max_tokens) {
+			tokens[count] = { line + start, i - start };
+		}
+		count++;
+	}
+	return count;
+}
+
+bool picross::parse_int(Token token, int& value) {
+	uint64_t wide;
+	if (!parse_uint64(token, wide) || wide > 0x7FFFFFFF) {
+		return false;
+	}
+	value = static_cast<int>(wide);
+	return true;
+}
+
+bool picross::parse_uint64(Token token, uint64_t& value) {
+	if (token.length == 0 || token.length > 19) {
+		return false;
+	}
+	value = 0;
+	for (size_t i = 0; i < token.length; i++) {
+		char c = token.text[i];
+		if (c < '0' || c > '9') {
+			return false;
+		}
+		value = value * 10 + (c - '0');
+	}
+	return true;
+}
+
+// Reads hints into the set, returns false if they aren't written correctly
+// A hint of 0 adds nothing, which is how a line with no hints is written
+bool picross::parse_clues(Token token, ClueSet& clues) {
+	clues.clear();
+	int run = 0;
+	int color = 0;
+	bool has_digit = false;
+	bool in_color = false;
+	for (size_t i = 0; i <= token.length; i++) {
+		char c = i < token.length ? token.text[i] : '/';
+		if (c >= '0' && c <= '9') {
+			int& value = in_color ? color : run;
+			value = value * 10 + (c - '0');
+			if (value > MAX_BOARD_SIDE) {
+				return false;
+			}
+			has_digit = true;
+		}
+		else if (c == ':' && has_digit && !in_color) {
+			in_color = true;
+			has_digit = false;
+		}
+		else if (c == ',' || c == '/') {
+			if (!has_digit || (in_color && (color < 1 || color > MAX_COLORS))) {
+				return false;
+			}
+			if (run > 0) {
+				clues.add_hint(run, in_color ? color : 1);
+			}
+			if (c == '/') {
+				clues.end_line();
+			}
+			run = 0;
+			color = 0;
+			has_digit = false;
+			in_color = false;
+		}
+		else {
+			return false;
+		}
+	}
+	return true;
+}
+
+void picross::format_clues(const ClueSet& clues, string& out) {
+	for (int line = 0; line < clues.line_count(); line++) {
+		if (line > 0) {
+			out.push_back('/');
+		}
+		if (clues.size(line) == 0) {
+			out.push_back('0');
+		}
+		const int* colors = clues.line_colors(line);
+		for (int i = 0; i < clues.size(line); i++) {
+			if (i > 0) {
+				out.push_back(',');
+			}
+			append_int(out, clues.begin(line)[i]);
+			if (colors[i] != 1) {
+				out.push_back(':');
+				append_int(out, colors[i]);
+			}
+		}
+	}
+}
+
+// Reads the bits into the board, returns false if there isn't exactly one digit for every space
+// The digits are checked first so the board knows how many colors it needs before anything is put in it.
+// Each row is then packed into a word for each color so the board only gets one set_row_word for every 64 spaces of a color
+bool picross::parse_bits(Token token, int width, int height, TiledBoard& board) {
+	if (token.length != static_cast<size_t>(width) * height) {
+		return false;
+	}
+
+	// Anything other than a digit makes highest bigger than MAX_COLORS, so the characters are checked without a branch for each one
+	unsigned int highest = 0;
+	for (size_t i = 0; i < token.length; i++) {
+		highest = max(highest, static_cast<unsigned int>(static_cast<unsigned char>(token.text[i] - '0')));
+	}
+	if (highest > static_cast<unsigned int>(MAX_COLORS)) {
+		return false;
+	}
+	int colors = max(static_cast<int>(highest), 1);
+	board.resize(width, height, colors);
+
+	const char* bits = token.text;
+	for (int y = 0; y < height; y++) {
+		for (int tile_column = 0; tile_column < board.tile_columns; tile_column++) {
+			int start = tile_column * TILE_SIZE;
+			int end = min(start + TILE_SIZE, width);
+			if (colors == 1) {
+				uint64_t word = 0;
+				for (int x = start; x < end; x++) {
+					word |= static_cast<uint64_t>(bits[x] - '0') << (x - start);
+				}
+				if (word != 0) {
+					board.set_row_word(0, tile_column, y, word);
+				}
+				continue;
+			}
+
+			// Empty spaces go in words[0], which is never put on the board
+			uint64_t words[MAX_COLORS + 1] = {};
+			for (int x = start; x < end; x++) {
+				words[bits[x] - '0'] |= 1ull << (x - start);
+			}
+			for (int color = 1; color <= colors; color++) {
+				if (words[color] != 0) {
+					board.set_row_word(color_plane(color), tile_column, y, words[color]);
+				}
+			}
+		}
+		bits += width;
+	}
+	return true;
+}
+
+void picross::format_bits(const TiledBoard& board, string& out) {
+	for (int y = 0; y < board.height; y++) {
+		for (int tile_column = 0; tile_column < board.tile_columns; tile_column++) {
+			int end = min(TILE_SIZE, board.width - tile_column * TILE_SIZE);
+			size_t start = out.size();
+			out.append(end, '0');
+			for (int color = 1; color <= board.colors; color++) {
+				uint64_t word = board.row_word(color_plane(color), tile_column, y);
+				while (word != 0) {
+					out[start + count_trailing_zeros(word)] = static_cast<char>('0' + color);
+					word &= word - 1;
+				}
+			}
+		}
+	}
+}
+
+// Makes a random puzzle from its own seed so it can run on any thread. Each space is filled with the chance percent, like
+// Board::generate_board, but the random numbers are used a row at a time, so the same seed doesn't make the same board as the game
+// Filled spaces are given a random color when there is more than one
+void picross::generate_puzzle(int width, int height, double percent, uint64_t seed, TiledBoard& board, int colors) {
+	board.resize(width, height, colors);
+	uint64_t state = seed;
+	uint64_t threshold = static_cast<uint64_t>(percent * 4294967296.0);
+	for (int y = 0; y < height; y++) {
+		for (int tile_column = 0; tile_column < board.tile_columns; tile_column++) {
+			int end = min(TILE_SIZE, width - tile_column * TILE_SIZE);
+			uint64_t words[MAX_COLORS] = {};
+			for (int i = 0; i < end; i++) {
+				if (random_int(state) < threshold) {
+					int color = colors == 1 ? 0 : random_int(state) % colors;
+					words[color] |= 1ull << i;
+				}
+			}
+			for (int color = 0; color < colors; color++) {
+				if (words[color] != 0) {
+					board.set_row_word(color_plane(color + 1), tile_column, y, words[color]);
+				}
+			}
+		}
+	}
+}
+
+// Answers a request line, the response is added to the end of response without a newline
+// STATS requests are only recognized, the caller has the counters so it writes the response
+RequestKind picross::handle_request(const char* line, size_t length, RequestContext& context, const picross::SolveLimits& limits, string& response) {
+	Token tokens[8];
+	int count = split_tokens(line, length, tokens, 8);
+	if (count == 0) {
+		response.append("-");
+		return fail(response, "empty request");
+	}
+	response.append(tokens[0].text, tokens[0].length);
+	if (count == 1) {
+		return fail(response, "missing command");
+	}
+
+	Token command = tokens[1];
+	if (token_is(command, "STATS")) {
+		return count == 2 ? REQUEST_STATS : fail(response, "STATS takes no arguments");
+	}
+
+	// The command is checked before its arguments so that an unknown command isn't reported as a bad board size
+	bool generate = token_is(command, "GENERATE");
+	bool verify = token_is(command, "VERIFY");
+	bool solve = token_is(command, "SOLVE");
+	bool unique = token_is(command, "UNIQUE");
+	if (!generate && !verify && !solve && !unique) {
+		return fail(response, "unknown command");
+	}
+
+	int width;
+	int height;
+	if (count < 4 || !parse_size(tokens[2], tokens[3], width, height)) {
+		return fail(response, "bad board size");
+	}
+
+	if (generate) {
+		uint64_t seed;
+		double percent = globals::PERCENT_CORRECT;
+		int colors = 1;
+		if (count < 5 || count > 7 || !parse_uint64(tokens[4], seed) || (count >= 6 && !parse_percent(tokens[5], percent))
+			|| (count == 7 && (!parse_int(tokens[6], colors) || colors < 1 || colors > MAX_COLORS))) {
+			return fail(response, "GENERATE takes a width, height, seed and an optional percent and number of colors");
+		}
+		generate_puzzle(width, height, percent, seed, context.board, colors);
+		extract_color_clues(context.board, context.rows, context.columns, context.clue_scratch);
+		response.append(" OK ");
+		format_clues(context.rows, response);
+		response.push_back(' ');
+		format_clues(context.columns, response);
+		response.push_back(' ');
+		format_bits(context.board, response);
+		return REQUEST_GENERATE;
+	}
+
+	if (count != (verify ? 7 : 6)) {
+		return fail(response, verify ? "VERIFY takes a width, height, row hints, column hints and bits" : "SOLVE and UNIQUE take a width, height, row hints and column hints");
+	}
+	if (!parse_clues(tokens[4], context.rows) || context.rows.line_count() != height) {
+		return fail(response, "bad row hints");
+	}
+	if (!parse_clues(tokens[5], context.columns) || context.columns.line_count() != width) {
+		return fail(response, "bad column hints");
+	}
+
+	// A submission is correct if it has the same hints as the puzzle, so any solution of a puzzle with more than one is accepted
+	if (verify) {
+		if (!parse_bits(tokens[6], width, height, context.board)) {
+			return fail(response, "bad bits");
+		}
+		extract_color_clues(context.board, context.found_rows, context.found_columns, context.clue_scratch);
+		bool correct = context.found_rows == context.rows && context.found_columns == context.columns;
+		response.append(correct ? " OK CORRECT" : " OK INCORRECT");
+		return REQUEST_VERIFY;
+	}
+
+	Solver& solver = context.solver;
+	int found = 0;
+	if (solver.load(context.rows, context.columns)) {
+		found = solver.solve(solve ? 1 : 2, limits);
+	}
+
+	if (found < 0) {
+		response.append(" OK GAVE_UP");
+	}
+	else if (found == 0) {
+		response.append(" OK NO_SOLUTION");
+	}
+	else if (unique) {
+		response.append(found == 1 ? " OK UNIQUE" : " OK MULTIPLE");
+	}
+	else {
+		response.append(" OK SOLVED ");
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				response.push_back(static_cast<char>('0' + solver.solution_color(x, y)));
+			}
+		}
+	}
+	return solve ? REQUEST_SOLVE : REQUEST_UNIQUE;
+}
\ No newline at end of file
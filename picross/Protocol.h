@@ -0,0 +1,81 @@
+#ifndef PROTOCOL_H_INCLUDED
+#define PROTOCOL_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Clues.h"
+#include "Solver.h"
+#include "TiledBoard.h"
+
+// The daemon reads one request a line and answers each with one line, in the same order
+//
+//   <id> VERIFY <width> <height> <row hints> <column hints> <bits>    -> <id> OK CORRECT | <id> OK INCORRECT
+//   <id> SOLVE <width> <height> <row hints> <column hints>            -> <id> OK SOLVED <bits> | <id> OK NO_SOLUTION | <id> OK GAVE_UP
+//   <id> UNIQUE <width> <height> <row hints> <column hints>           -> <id> OK UNIQUE | MULTIPLE | NO_SOLUTION | GAVE_UP
+//   <id> GENERATE <width> <height> <seed> [percent [colors]]          -> <id> OK <row hints> <column hints> <bits>
+//   <id> STATS                                                        -> <id> OK <name>=<value> ...
+//
+// Hints are written a line at a time with lines split by / and hints in a line split by commas, a line with no hints is 0
+// So 3/1,1/0 is three rows with hints 3, 1 1 and nothing. Bits are the spaces a row at a time as 0s and 1s, like bitstring.txt
+// Puzzles with more than one color write a hint's color after it (2:3 is a hint of 2 in color 3, no color is color 1) and use the color's digit in the bits
+// Anything that goes wrong is answered with <id> ERROR <message>
+namespace picross {
+	enum RequestKind {
+		REQUEST_VERIFY,
+		REQUEST_SOLVE,
+		REQUEST_UNIQUE,
+		REQUEST_GENERATE,
+		REQUEST_STATS,
+		REQUEST_INVALID,
+		REQUEST_KINDS
+	};
+
+	// The names of each kind of request, in the same order as RequestKind
+	extern const char* const REQUEST_NAMES[REQUEST_KINDS];
+
+	// A piece of a request line, requests are read where they are instead of being copied
+	struct Token {
+		const char* text;
+		size_t length;
+	};
+
+	// Splits a line at spaces, returns the number of tokens. Tokens past max_tokens are counted but not stored
+	int split_tokens(const char* line, size_t length, Token* tokens, int max_tokens);
+
+	bool parse_int(Token token, int& value);
+	bool parse_uint64(Token token, uint64_t& value);
+
+	// Reads hints into the set, returns false if they aren't written correctly
+	bool parse_clues(Token token, ClueSet& clues);
+	void format_clues(const ClueSet& clues, std::string& out);
+
+	// Reads the bits into the board, returns false if there isn't exactly one digit for every space
+	// The board gets as many colors as the highest digit
+	bool parse_bits(Token token, int width, int height, TiledBoard& board);
+	void format_bits(const TiledBoard& board, std::string& out);
+
+	// Makes a random puzzle from its own seed so it can run on any thread. Each space is filled with the chance percent, like
+	// Board::generate_board, but the random numbers are used a row at a time, so the same seed doesn't make the same board as the game
+	void generate_puzzle(int width, int height, double percent, uint64_t seed, TiledBoard& board, int colors = 1);
+
+	// Everything a worker needs to answer requests. Each worker keeps one, so once the buffers have grown to the largest
+	// request they have seen, answering a request doesn't allocate
+	struct RequestContext {
+		TiledBoard board;
+		ClueSet rows;
+		ClueSet columns;
+		ClueSet found_rows;
+		ClueSet found_columns;
+		ClueScratch clue_scratch;
+		Solver solver;
+	};
+
+	// Answers a request line, the response is added to the end of response without a newline
+	// STATS requests are only recognized, the caller has the counters so it writes the response
+	// limits is how much work SOLVE and UNIQUE can do before giving up
+	RequestKind handle_request(const char* line, size_t length, RequestContext& context, const SolveLimits& limits, std::string& response);
+}
+
+#endif
\ No newline at end of file
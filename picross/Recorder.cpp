@@ -0,0 +1,206 @@
+#include <algorithm>
+
+#include "Functions.h"
+#include "Recorder.h"
+
+using namespace std;
+using picross::Recorder;
+using picross::Trace;
+using picross::TraceEvent;
+
+// Every trace starts with these bytes so that other files aren't read as traces
+static const char TRACE_MAGIC[4] = { 'P', 'X', 'T', 'R' };
+// Version 2 added the number of colors after the board size, version 1 traces are still read as puzzles with one color
+static const uint8_t TRACE_VERSION = 2;
+
+// Messages are stored as their position in this list so that each one takes a single byte
+static const UINT TRACE_MESSAGES[] = { WM_LBUTTONDOWN, WM_RBUTTONDOWN, WM_MOUSEMOVE, WM_KEYDOWN, WM_MOUSEWHEEL, WM_MOUSEHWHEEL, WM_SIZE };
+static const int TRACE_MESSAGE_COUNT = sizeof(TRACE_MESSAGES) / sizeof(TRACE_MESSAGES[0]);
+
+// The largest window size a trace can hold, WM_SIZE only has 16 bits for each side
+static const uint64_t MAX_TRACE_WINDOW_SIDE = 0xFFFF;
+
+// Reads a puzzle word written by Recorder::write_word, returns false if the file ends first
+static bool read_word(istream& in, uint64_t& word) {
+	unsigned char bytes[8];
+	if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+		return false;
+	}
+	word = 0;
+	for (int i = 7; i >= 0; i--) {
+		word = (word << 8) | bytes[i];
+	}
+	return true;
+}
+
+// Reads a number written with write_varint, returns false if the file ends first
+static bool read_varint(istream& in, uint64_t& value) {
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		int byte = in.get();
+		if (byte == EOF) {
+			return false;
+		}
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+Trace::Trace() :seed{ 0 }, random_state{ 0 }, window_width{ 0 }, window_height{ 0 } {}
+
+// Reads a trace file, returns false if the file can't be read or isn't a trace
+bool Trace::load(const string& path) {
+	ifstream in(path, ios::binary);
+	if (!in.is_open()) {
+		return false;
+	}
+
+	char magic[4];
+	if (!in.read(magic, sizeof(magic)) || !equal(magic, magic + 4, TRACE_MAGIC)) {
+		return false;
+	}
+	int version = in.get();
+	if (version < 1 || version > TRACE_VERSION) {
+		return false;
+	}
+
+	uint64_t values[7] = { 0, 0, 0, 0, 0, 0, 1 };
+	for (int i = 0; i < (version == 1 ? 6 : 7); i++) {
+		if (!read_varint(in, values[i])) {
+			return false;
+		}
+	}
+	// The sizes are checked before anything is allocated from them so that a broken file can't ask for a huge board
+	uint64_t max_side = static_cast<uint64_t>(MAX_BOARD_SIDE);
+	if (values[2] > MAX_TRACE_WINDOW_SIDE || values[3] > MAX_TRACE_WINDOW_SIDE || values[4] < 1 || values[4] > max_side
+		|| values[5] < 1 || values[5] > max_side || values[6] < 1 || values[6] > static_cast<uint64_t>(MAX_COLORS)) {
+		return false;
+	}
+	seed = values[0];
+	random_state = values[1];
+	window_width = static_cast<int>(values[2]);
+	window_height = static_cast<int>(values[3]);
+
+	// The puzzle is stored as the row words of each tile for each color, one row of the board at a time
+	// The words are little endian so that traces can be replayed on any machine
+	puzzle.resize(static_cast<int>(values[4]), static_cast<int>(values[5]), static_cast<int>(values[6]));
+	for (int y = 0; y < puzzle.height; y++) {
+		for (int color = 1; color <= puzzle.colors; color++) {
+			for (int tile_column = 0; tile_column < puzzle.tile_columns; tile_column++) {
+				uint64_t word;
+				if (!read_word(in, word)) {
+					return false;
+				}
+				puzzle.set_row_word(color_plane(color), tile_column, y, word);
+			}
+		}
+	}
+
+	events.clear();
+	uint64_t time = 0;
+	uint64_t delta;
+	while (read_varint(in, delta)) {
+		int code = in.get();
+		uint64_t wParam;
+		uint64_t lParam;
+		if (code == EOF || code >= TRACE_MESSAGE_COUNT || !read_varint(in, wParam) || !read_varint(in, lParam)) {
+			return false;
+		}
+
+		time += delta;
+		events.push_back(TraceEvent{ time, TRACE_MESSAGES[code], static_cast<WPARAM>(wParam), static_cast<LPARAM>(static_cast<uint32_t>(lParam)) });
+	}
+
+	return true;
+}
+
+Recorder::Recorder() :active{ false } {}
+
+// Starts recording to a file, returns false if the file can't be opened or the board is too big for a trace to hold
+bool Recorder::start(const string& path, uint64_t seed, const Board& board) {
+	// Trace::load won't read boards bigger than this, so they aren't written at all
+	if (board.correct_board.width > MAX_BOARD_SIDE || board.correct_board.height > MAX_BOARD_SIDE) {
+		return false;
+	}
+
+	file.open(path, ios::binary | ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+	file.put(static_cast<char>(TRACE_VERSION));
+
+	write_varint(seed);
+	write_varint(get_random_state());
+	write_varint(window_width);
+	write_varint(window_height);
+	write_varint(board.correct_board.width);
+	write_varint(board.correct_board.height);
+	write_varint(board.correct_board.colors);
+
+	const TiledBoard& puzzle = board.correct_board;
+	for (int y = 0; y < puzzle.height; y++) {
+		for (int color = 1; color <= puzzle.colors; color++) {
+			for (int tile_column = 0; tile_column < puzzle.tile_columns; tile_column++) {
+				write_word(puzzle.row_word(color_plane(color), tile_column, y));
+			}
+		}
+	}
+
+	last_event = chrono::steady_clock::now();
+	active = true;
+	return true;
+}
+
+// Adds an input message to the trace, mouse positions have to be in the window's coordinates
+void Recorder::record(UINT message, WPARAM wParam, LPARAM lParam) {
+	int code = 0;
+	while (code < TRACE_MESSAGE_COUNT && TRACE_MESSAGES[code] != message) {
+		code++;
+	}
+	if (!active || code == TRACE_MESSAGE_COUNT) {
+		return;
+	}
+
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	write_varint(chrono::duration_cast<chrono::microseconds>(now - last_event).count());
+	last_event = now;
+
+	file.put(static_cast<char>(code));
+	write_varint(static_cast<uint32_t>(wParam));
+	write_varint(static_cast<uint32_t>(lParam));
+}
+
+// Finishes writing the trace and closes the file
+void Recorder::stop() {
+	if (active) {
+		file.close();
+		active = false;
+	}
+}
+
+bool Recorder::recording() const {
+	return active;
+}
+
+// Writes a puzzle word as 8 little endian bytes, the bits of a puzzle are too random for varints to make them smaller
+void Recorder::write_word(uint64_t word) {
+	char bytes[8];
+	for (int i = 0; i < 8; i++) {
+		bytes[i] = static_cast<char>((word >> (i * 8)) & 0xFF);
+	}
+	file.write(bytes, sizeof(bytes));
+}
+
+// Writes a number 7 bits at a time, small numbers like time differences and mouse flags only take a byte or two
+void Recorder::write_varint(uint64_t value) {
+	while (value >= 0x80) {
+		file.put(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	file.put(static_cast<char>(value));
+}
\ No newline at end of file
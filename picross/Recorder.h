@@ -0,0 +1,74 @@
+#ifndef RECORDER_H_INCLUDED
+#define RECORDER_H_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "Globals.h"
+#include "TiledBoard.h"
+
+namespace picross {
+	// A single user input from a recorded session
+	struct TraceEvent {
+		// Microseconds since the recording started
+		uint64_t time;
+
+		UINT message;
+		WPARAM wParam;
+		LPARAM lParam;
+	};
+
+	// A recorded session that has been read back from a trace file
+	class Trace {
+	public:
+		// The seed the session started with and the state of the random number generator when the recording started
+		// The state is what makes puzzles generated during the session come out the same when replayed
+		uint64_t seed;
+		uint64_t random_state;
+
+		int window_width;
+		int window_height;
+
+		// The correct board when the recording started
+		TiledBoard puzzle;
+
+		std::vector<TraceEvent> events;
+
+		Trace();
+
+		// Reads a trace file, returns false if the file can't be read or isn't a trace
+		bool load(const std::string& path);
+	};
+
+	// Writes the user inputs of a session to a compact binary trace so that the session can be replayed later
+	// The trace starts with the seed, the window size and the puzzle, each input after that is a time difference, a message and its parameters
+	class Recorder {
+	public:
+		Recorder();
+
+		// Starts recording to a file, returns false if the file can't be opened or the board is too big for a trace to hold
+		bool start(const std::string& path, uint64_t seed, const Board& board);
+
+		// Adds an input message to the trace, mouse positions have to be in the window's coordinates
+		void record(UINT message, WPARAM wParam, LPARAM lParam);
+
+		// Finishes writing the trace and closes the file
+		void stop();
+
+		bool recording() const;
+
+	private:
+		std::ofstream file;
+		std::chrono::steady_clock::time_point last_event;
+		bool active;
+
+		void write_word(uint64_t word);
+		void write_varint(uint64_t value);
+	};
+}
+
+#endif
\ No newline at end of file
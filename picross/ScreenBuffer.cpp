@@ -0,0 +1,126 @@
+#include <cstdio>
+
+#include "ScreenBuffer.h"
+
+using namespace std;
+using picross::ScreenBuffer;
+using picross::ScreenCell;
+
+bool ScreenCell::operator==(const ScreenCell& other) const {
+	return glyph == other.glyph && foreground == other.foreground && background == other.background && bold == other.bold;
+}
+
+bool ScreenCell::operator!=(const ScreenCell& other) const {
+	return !(*this == other);
+}
+
+// Returns the closest color in the 256 color palette, so the terminal can use the same colors as the window
+// Grays use the gray ramp since it has finer steps than the color cube
+uint8_t picross::palette_color(COLORREF color) {
+	int red = GetRValue(color);
+	int green = GetGValue(color);
+	int blue = GetBValue(color);
+
+	if (red == green && green == blue) {
+		if (red < 4) {
+			return 16;
+		}
+		if (red > 246) {
+			return 231;
+		}
+		return static_cast<uint8_t>(232 + (red - 8) * 24 / 240);
+	}
+
+	// The color cube has 6 levels for each of red, green and blue
+	auto level = [](int value) { return value < 48 ? 0 : value < 115 ? 1 : (value - 35) / 40; };
+	return static_cast<uint8_t>(16 + 36 * level(red) + 6 * level(green) + level(blue));
+}
+
+ScreenBuffer::ScreenBuffer() :width{ 0 }, height{ 0 }, full_redraw{ true }, last_changed{ 0 } {}
+
+// Changes the size of the screen, the next frame redraws everything
+void ScreenBuffer::resize(int new_width, int new_height) {
+	width = new_width;
+	height = new_height;
+	front.assign(static_cast<size_t>(width) * height, ScreenCell{ ' ', 0, 0, false });
+	back = front;
+	invalidate();
+}
+
+// Makes the next frame redraw everything, for when the terminal may have been changed by something else
+void ScreenBuffer::invalidate() {
+	full_redraw = true;
+}
+
+// Fills the next frame with spaces
+void ScreenBuffer::clear(uint8_t background) {
+	fill(back.begin(), back.end(), ScreenCell{ ' ', background, background, false });
+}
+
+// Puts a character in the next frame, characters off the screen are ignored
+void ScreenBuffer::put(int x, int y, char glyph, uint8_t foreground, uint8_t background, bool bold) {
+	if (x < 0 || y < 0 || x >= width || y >= height) {
+		return;
+	}
+	back[static_cast<size_t>(y) * width + x] = ScreenCell{ glyph, foreground, background, bold };
+}
+
+// Puts a line of text in the next frame starting at x, it is cut off at the edge of the screen
+void ScreenBuffer::write(int x, int y, const string& text, uint8_t foreground, uint8_t background, bool bold) {
+	for (size_t i = 0; i < text.size(); i++) {
+		put(x + static_cast<int>(i), y, text[i], foreground, background, bold);
+	}
+}
+
+// Builds the escape sequences that turn the terminal into the next frame and remembers the frame as what is on the screen
+// Cursor moves are skipped for cells next to each other and colors are only sent when they change
+const string& ScreenBuffer::present() {
+	output.clear();
+	last_changed = 0;
+
+	// The cursor position and colors the terminal currently has, -1 means unknown
+	int cursor_x = -1;
+	int cursor_y = -1;
+	ScreenCell style = { ' ', 0, 0, false };
+	bool style_known = false;
+
+	char sequence[48];
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			size_t index = static_cast<size_t>(y) * width + x;
+			const ScreenCell& cell = back[index];
+			if (!full_redraw && cell == front[index]) {
+				continue;
+			}
+
+			if (cursor_x != x || cursor_y != y) {
+				snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", y + 1, x + 1);
+				output += sequence;
+			}
+
+			if (!style_known || cell.foreground != style.foreground || cell.background != style.background || cell.bold != style.bold) {
+				snprintf(sequence, sizeof(sequence), "\x1b[%s38;5;%d;48;5;%dm", cell.bold ? "0;1;" : "0;", cell.foreground, cell.background);
+				output += sequence;
+				style = cell;
+				style_known = true;
+			}
+
+			output += cell.glyph;
+			front[index] = cell;
+			last_changed++;
+
+			// Writing a character moves the cursor one to the right, except at the last column where terminals keep it in place
+			cursor_x = x + 1 < width ? x + 1 : -1;
+			cursor_y = y;
+		}
+	}
+
+	full_redraw = false;
+	return output;
+}
+
+// The number of cells that were sent the last time the frame was presented
+int ScreenBuffer::changed_cells() const {
+	return last_changed;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef SCREEN_BUFFER_H_INCLUDED
+#define SCREEN_BUFFER_H_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Globals.h"
+
+namespace picross {
+	// A single character on a terminal screen, colors are indexes into the 256 color palette
+	struct ScreenCell {
+		char glyph;
+		uint8_t foreground;
+		uint8_t background;
+		bool bold;
+
+		bool operator==(const ScreenCell& other) const;
+		bool operator!=(const ScreenCell& other) const;
+	};
+
+	// Returns the closest color in the 256 color palette, so the terminal can use the same colors as the window
+	uint8_t palette_color(COLORREF color);
+
+	// Keeps a shadow copy of what is on the terminal and the next frame being drawn
+	// Presenting the frame only writes the escape sequences for the cells that changed, which keeps redraws small over slow connections
+	class ScreenBuffer {
+	public:
+		int width;
+		int height;
+
+		ScreenBuffer();
+
+		// Changes the size of the screen, the next frame redraws everything
+		void resize(int new_width, int new_height);
+
+		// Makes the next frame redraw everything, for when the terminal may have been changed by something else
+		void invalidate();
+
+		// Fills the next frame with spaces
+		void clear(uint8_t background);
+
+		// Puts a character in the next frame, characters off the screen are ignored
+		void put(int x, int y, char glyph, uint8_t foreground, uint8_t background, bool bold = false);
+
+		// Puts a line of text in the next frame starting at x, it is cut off at the edge of the screen
+		void write(int x, int y, const std::string& text, uint8_t foreground, uint8_t background, bool bold = false);
+
+		// Builds the escape sequences that turn the terminal into the next frame and remembers the frame as what is on the screen
+		// Cursor moves are skipped for cells next to each other and colors are only sent when they change
+		const std::string& present();
+
+		// The number of cells that were sent the last time the frame was presented
+		int changed_cells() const;
+
+	private:
+		std::vector<ScreenCell> front;
+		std::vector<ScreenCell> back;
+		std::string output;
+		bool full_redraw;
+		int last_changed;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,771 @@
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "Bits.h"
+#include "Solver.h"
+
+using namespace std;
+using picross::LineSolver;
+using picross::Solver;
+
+namespace {
+	// Trails longer than this are freed after a solve instead of being kept for the next puzzle
+	const size_t RETAINED_TRAIL_ENTRIES = 1 << 20;
+
+	int word_count(int bits) {
+		return (bits + 63) / 64;
+	}
+
+	// Returns how many spaces a line has left over after its hints and the gaps that same colored hints need between them
+	int line_slack(const picross::ClueSet& clues, int line, int length) {
+		const int* runs = clues.begin(line);
+		const int* colors = clues.line_colors(line);
+		int used = 0;
+		for (int i = 0; i < clues.size(line); i++) {
+			used += runs[i];
+			if (i > 0 && colors[i] == colors[i - 1]) {
+				used++;
+			}
+		}
+		return max(length - used, 0);
+	}
+
+	// Moves every bit up (to a higher position) by shift, dst can be the same as src
+	void shift_up(uint64_t* dst, const uint64_t* src, int shift, int words) {
+		int word_shift = shift / 64;
+		int bit_shift = shift % 64;
+		for (int i = words - 1; i >= 0; i--) {
+			int from = i - word_shift;
+			uint64_t value = 0;
+			if (from >= 0) {
+				value = src[from] << bit_shift;
+				if (bit_shift != 0 && from > 0) {
+					value |= src[from - 1] >> (64 - bit_shift);
+				}
+			}
+			dst[i] = value;
+		}
+	}
+
+	// Moves every bit down (to a lower position) by shift, dst can be the same as src
+	void shift_down(uint64_t* dst, const uint64_t* src, int shift, int words) {
+		int word_shift = shift / 64;
+		int bit_shift = shift % 64;
+		for (int i = 0; i < words; i++) {
+			int from = i + word_shift;
+			uint64_t value = 0;
+			if (from < words) {
+				value = src[from] >> bit_shift;
+				if (bit_shift != 0 && from + 1 < words) {
+					value |= src[from + 1] << (64 - bit_shift);
+				}
+			}
+			dst[i] = value;
+		}
+	}
+
+	// Reverses the first length bits, src has to be 0 past length
+	void reverse_bits(uint64_t* dst, const uint64_t* src, int length, int words) {
+		int used = word_count(length);
+		for (int i = 0; i < used; i++) {
+			dst[used - 1 - i] = picross::reverse_word(src[i]);
+		}
+		for (int i = used; i < words; i++) {
+			dst[i] = 0;
+		}
+		shift_down(dst, dst, used * 64 - length, words);
+	}
+
+	// Adds every position that can be reached from the seeds by stepping over spaces that can be empty
+	// Adding a seed to a run of the mask carries through the whole run and lands on the position after it, so xoring
+	// the mask back out leaves every position from the seed to the end of its run. The carry crosses words like any long add
+	void closure(uint64_t* dst, const uint64_t* seeds, const uint64_t* mask, int words) {
+		uint64_t carry = 0;
+		for (int i = 0; i < words; i++) {
+			uint64_t sum = mask[i] + (seeds[i] & mask[i]);
+			uint64_t next_carry = sum < mask[i];
+			sum += carry;
+			next_carry |= sum < carry;
+			carry = next_carry;
+			dst[i] = (sum ^ mask[i]) | seeds[i];
+		}
+	}
+}
+
+// Finds prefix[0] to prefix[run_count] and the possible starts of each hint for a line
+// fits[b] has a bit at every start where 2^b spaces in a row can be a color, so a hint of any length can be checked
+// by anding a shifted level for each bit of its length. Each color that has a hint gets its own levels
+bool LineSolver::forward(int length, const int* runs, const int* colors, int run_count, int color_count, const uint64_t* fill, const uint64_t* empty,
+	uint64_t* reach, uint64_t* run_starts) {
+	int words = word_count(length + 1);
+	uint64_t* seeds = temp.data() + (color_count + 1) * words;
+	uint64_t* piece = seeds + words;
+
+	int longest = 1;
+	for (int k = 0; k < run_count; k++) {
+		longest = max(longest, runs[k]);
+	}
+	int levels = 1;
+	while ((1 << levels) <= longest) {
+		levels++;
+	}
+	if (fits.size() < static_cast<size_t>(color_count * levels * words)) {
+		fits.resize(color_count * levels * words);
+	}
+	for (int color = 1; color <= color_count; color++) {
+		bool used = false;
+		for (int k = 0; k < run_count && !used; k++) {
+			used = colors[k] == color;
+		}
+		if (!used) {
+			continue;
+		}
+
+		uint64_t* color_fits = fits.data() + (color - 1) * levels * words;
+		const uint64_t* color_fill = fill + (color - 1) * words;
+		copy(color_fill, color_fill + words, color_fits);
+		for (int b = 1; b < levels; b++) {
+			uint64_t* level = color_fits + b * words;
+			const uint64_t* below = level - words;
+			shift_down(level, below, 1 << (b - 1), words);
+			for (int i = 0; i < words; i++) {
+				level[i] &= below[i];
+			}
+		}
+	}
+
+	fill_n(seeds, words, 0);
+	seeds[0] = 1;
+	closure(reach, seeds, empty, words);
+
+	for (int k = 0; k < run_count; k++) {
+		const uint64_t* before = reach + k * words;
+		uint64_t* start = run_starts + k * words;
+		int run = runs[k];
+
+		// A hint needs an empty space before it if the hint before it is the same color, different colors can touch
+		if (k == 0 || colors[k] != colors[k - 1]) {
+			copy(before, before + words, start);
+		}
+		else {
+			for (int i = 0; i < words; i++) {
+				start[i] = before[i] & empty[i];
+			}
+			shift_up(start, start, 1, words);
+		}
+
+		const uint64_t* color_fits = fits.data() + (colors[k] - 1) * levels * words;
+		int offset = 0;
+		for (int b = 0; b < levels; b++) {
+			if ((run >> b) & 1) {
+				shift_down(piece, color_fits + b * words, offset, words);
+				for (int i = 0; i < words; i++) {
+					start[i] &= piece[i];
+				}
+				offset += 1 << b;
+			}
+		}
+
+		shift_up(seeds, start, run, words);
+		closure(reach + (k + 1) * words, seeds, empty, words);
+	}
+
+	const uint64_t* last = reach + run_count * words;
+	return (last[length / 64] >> (length % 64)) & 1;
+}
+
+// Solves a line where every hint is color 1
+bool LineSolver::solve(int length, const int* runs, int run_count, uint64_t* can_fill, uint64_t* can_empty) {
+	ones.assign(run_count, 1);
+	return solve(length, runs, ones.data(), run_count, 1, can_fill, can_empty);
+}
+
+// Solves the line in place, returns false if no placement of the hints fits
+// The end of the line is found by running the same pass over the reversed line with the hints reversed
+bool LineSolver::solve(int length, const int* runs, const int* colors, int run_count, int color_count, uint64_t* can_fill, uint64_t* can_empty) {
+	int words = word_count(length + 1);
+	int line_words = word_count(length);
+	size_t sets = static_cast<size_t>(run_count + 1) * words;
+	if (prefix.size() < sets) {
+		prefix.resize(sets);
+		suffix.resize(sets);
+		starts.resize(2 * sets);
+	}
+	if (temp.size() < static_cast<size_t>((2 * color_count + 5) * words)) {
+		temp.resize((2 * color_count + 5) * words);
+		reversed_fill.resize(color_count * words);
+		reversed_empty.resize(words);
+	}
+	reversed_runs.assign(runs, runs + run_count);
+	reverse(reversed_runs.begin(), reversed_runs.end());
+	reversed_colors.assign(colors, colors + run_count);
+	reverse(reversed_colors.begin(), reversed_colors.end());
+
+	// forward uses shifted and smear for its own work, so they are only used here after it is done
+	uint64_t* fill = temp.data();
+	uint64_t* empty = fill + color_count * words;
+	uint64_t* shifted = empty + words;
+	uint64_t* smear = shifted + words;
+	uint64_t* piece = smear + words;
+	uint64_t* new_empty = piece + words;
+	uint64_t* new_fill = new_empty + words;
+
+	for (int color = 0; color < color_count; color++) {
+		uint64_t* color_fill = fill + color * words;
+		copy(can_fill + color * line_words, can_fill + (color + 1) * line_words, color_fill);
+		fill_n(color_fill + line_words, words - line_words, 0);
+	}
+	copy(can_empty, can_empty + line_words, empty);
+	fill_n(empty + line_words, words - line_words, 0);
+
+	if (!forward(length, runs, colors, run_count, color_count, fill, empty, prefix.data(), starts.data())) {
+		return false;
+	}
+	for (int color = 0; color < color_count; color++) {
+		reverse_bits(reversed_fill.data() + color * words, fill + color * words, length, words);
+	}
+	reverse_bits(reversed_empty.data(), empty, length, words);
+	forward(length, reversed_runs.data(), reversed_colors.data(), run_count, color_count, reversed_fill.data(), reversed_empty.data(),
+		suffix.data(), starts.data() + sets);
+
+	// Flips the reversed pass back so that suffix[j] is the positions that the last j hints can all fit after
+	for (int j = 0; j <= run_count; j++) {
+		uint64_t* set = suffix.data() + j * words;
+		reverse_bits(shifted, set, length + 1, words);
+		copy(shifted, shifted + words, set);
+	}
+
+	fill_n(new_fill, color_count * words, 0);
+	fill_n(new_empty, words, 0);
+	for (int k = 0; k <= run_count; k++) {
+		const uint64_t* before = prefix.data() + k * words;
+		const uint64_t* after = suffix.data() + (run_count - k) * words;
+
+		// A space can be empty if the first k hints fit before it and the rest fit after it
+		shift_down(shifted, after, 1, words);
+		for (int i = 0; i < words; i++) {
+			new_empty[i] |= before[i] & shifted[i] & empty[i];
+		}
+		if (k == 0) {
+			continue;
+		}
+
+		// A start is only kept if the rest of the hints fit after the hint ends, which needs a gap if the next hint is the same color
+		// shifted is still the suffix moved down by one, so it only needs the gap space to be able to be empty
+		int run = runs[k - 1];
+		const uint64_t* start = starts.data() + (k - 1) * words;
+		if (k < run_count && colors[k] == colors[k - 1]) {
+			for (int i = 0; i < words; i++) {
+				shifted[i] &= empty[i];
+			}
+		}
+		else {
+			copy(after, after + words, shifted);
+		}
+		shift_down(shifted, shifted, run, words);
+		for (int i = 0; i < words; i++) {
+			smear[i] = start[i] & shifted[i];
+		}
+
+		// Spreads each start over the spaces its hint covers, doubling the width covered at each step
+		uint64_t* color_fill = new_fill + (colors[k - 1] - 1) * words;
+		int offset = 0;
+		for (int b = 0; (1 << b) <= run; b++) {
+			if ((run >> b) & 1) {
+				shift_up(piece, smear, offset, words);
+				for (int i = 0; i < words; i++) {
+					color_fill[i] |= piece[i];
+				}
+				offset += 1 << b;
+			}
+			if ((2 << b) <= run) {
+				shift_up(piece, smear, 1 << b, words);
+				for (int i = 0; i < words; i++) {
+					smear[i] |= piece[i];
+				}
+			}
+		}
+	}
+
+	for (int color = 0; color < color_count; color++) {
+		copy(new_fill + color * words, new_fill + color * words + line_words, can_fill + color * line_words);
+	}
+	copy(new_empty, new_empty + line_words, can_empty);
+	return true;
+}
+
+
+Solver::Solver() {
+	width = 0;
+	height = 0;
+	colors = 1;
+	row_clues = nullptr;
+	column_clues = nullptr;
+	row_words = 0;
+	column_words = 0;
+	state_words = 0;
+	phase_rows = true;
+	parallel_min_spaces = PARALLEL_MIN_SPACES;
+	next_block = 0;
+	failed = false;
+	finished_jobs = 0;
+	solutions_found = 0;
+	nodes = 0;
+	gave_up = false;
+	logging = false;
+	workers.resize(1);
+	point_state();
+}
+
+// Solves lines on this many threads, counting the thread that calls solve
+void Solver::set_threads(int count, int64_t min_spaces) {
+	parallel_min_spaces = min_spaces;
+	count = max(count, 1);
+	if (count == threads()) {
+		return;
+	}
+	pool.reset(count > 1 ? new ThreadPool(count - 1) : nullptr);
+	workers.resize(count);
+	jobs.resize(count - 1);
+	size_workers();
+}
+
+int Solver::threads() const {
+	return static_cast<int>(workers.size());
+}
+
+// Sets up a puzzle with every space unknown, returns false if the hints don't make a valid puzzle
+// Every color has to have as many spaces in the rows as in the columns
+bool Solver::load(const ClueSet& rows, const ClueSet& columns) {
+	row_clues = &rows;
+	column_clues = &columns;
+	width = columns.line_count();
+	height = rows.line_count();
+	colors = max(max(rows.highest_color(), columns.highest_color()), 1);
+	if (width <= 0 || height <= 0 || colors > MAX_COLORS) {
+		return false;
+	}
+	for (int color = 1; color <= colors; color++) {
+		if (rows.total(color) != columns.total(color)) {
+			return false;
+		}
+	}
+
+	// The atomics can't be copied, so the state is only replaced when it has to grow
+	row_words = word_count(width);
+	column_words = word_count(height);
+	state_words = (colors + 1) * (static_cast<size_t>(height) * row_words + static_cast<size_t>(width) * column_words);
+	if (state.size() < state_words) {
+		state = vector<atomic<uint64_t>>(state_words);
+	}
+	for (size_t i = 0; i < state_words; i++) {
+		state[i].store(0, memory_order_relaxed);
+	}
+	point_state();
+
+	for (int line = 0; line < height * (colors + 1); line++) {
+		for (int x = 0; x < width; x++) {
+			row_fill[line * row_words + x / 64].fetch_or(1ull << (x % 64), memory_order_relaxed);
+		}
+	}
+	for (int line = 0; line < width * (colors + 1); line++) {
+		for (int y = 0; y < height; y++) {
+			column_fill[line * column_words + y / 64].fetch_or(1ull << (y % 64), memory_order_relaxed);
+		}
+	}
+
+	// Every line starts dirty with all of its spaces touched, so the first phases start with the tightest lines
+	row_touched.assign(height, width);
+	column_touched.assign(width, height);
+	row_slack.resize(height);
+	column_slack.resize(width);
+	for (int y = 0; y < height; y++) {
+		row_slack[y] = line_slack(rows, y, width);
+	}
+	for (int x = 0; x < width; x++) {
+		column_slack[x] = line_slack(columns, x, height);
+	}
+
+	size_workers();
+	return true;
+}
+
+// Looks for up to max_solutions solutions, giving up when it runs into any of the limits
+// Returns the number of solutions found, or -1 if it gave up first
+int Solver::solve(int max_solutions, const SolveLimits& solve_limits) {
+	solutions_found = 0;
+	nodes = 0;
+	gave_up = false;
+	if (row_clues == nullptr) {
+		return 0;
+	}
+
+	limits = solve_limits;
+	deadline = chrono::steady_clock::now() + chrono::milliseconds(limits.milliseconds);
+	search(max_solutions);
+
+	// A puzzle that needed a lot of guesses shouldn't keep all of that memory around for every puzzle after it
+	trail.clear();
+	guesses.clear();
+	logging = false;
+	if (trail.capacity() > RETAINED_TRAIL_ENTRIES) {
+		trail.shrink_to_fit();
+		guesses.shrink_to_fit();
+	}
+	for (LineWorker& worker : workers) {
+		worker.trail.clear();
+		if (worker.trail.capacity() > RETAINED_TRAIL_ENTRIES) {
+			worker.trail.shrink_to_fit();
+		}
+	}
+
+	if (gave_up && solutions_found < max_solutions) {
+		return -1;
+	}
+	return solutions_found;
+}
+
+// Returns the color of a space in the first solution that was found, 0 if it is empty
+int Solver::solution_color(int x, int y) const {
+	for (int color = 0; color < colors; color++) {
+		if ((solution[(y * colors + color) * row_words + x / 64] >> (x % 64)) & 1) {
+			return color + 1;
+		}
+	}
+	return 0;
+}
+
+// Solves dirty lines until nothing changes, returns false if a line can't be solved or a limit was reached
+// Rows and columns take turns, so it is done once a row phase and a column phase in a row find nothing dirty
+bool Solver::propagate() {
+	bool rows = true;
+	int idle_phases = 0;
+	while (idle_phases < 2) {
+		int solved;
+		if (!run_phase(rows, solved) || over_limits()) {
+			return false;
+		}
+		idle_phases = solved == 0 ? idle_phases + 1 : 0;
+		rows = !rows;
+	}
+	return true;
+}
+
+// Checks the time and memory limits, sets gave_up if one was reached
+// The limits are checked between phases since a single phase of a huge puzzle can already take a while
+bool Solver::over_limits() {
+	if ((limits.milliseconds > 0 && chrono::steady_clock::now() > deadline) || trail.size() * sizeof(TrailEntry) > limits.trail_bytes) {
+		gave_up = true;
+	}
+	return gave_up;
+}
+
+// Solves every dirty line in one direction, solved is set to how many there were
+// The expected yield of a line is the possibilities ruled out in it since it was last solved, scaled up for lines with
+// little slack. Lines are solved a block at a time, the blocks with the most yield first and the best lines first in each block.
+// That finds a dead end sooner, and the threads never share a word in the other direction
+bool Solver::run_phase(bool rows, int& solved) {
+	vector<int>& touched = rows ? row_touched : column_touched;
+	const vector<int>& slack = rows ? row_slack : column_slack;
+	int length = rows ? width : height;
+
+	queue.clear();
+	block_yields.assign((touched.size() + LINE_BLOCK_SIZE - 1) / LINE_BLOCK_SIZE, 0);
+	for (int line = 0; line < static_cast<int>(touched.size()); line++) {
+		if (touched[line] != 0) {
+			int64_t yield = static_cast<int64_t>(touched[line]) * (length + 1) / (slack[line] + 1);
+			queue.push_back({ 0, yield, line });
+			block_yields[line / LINE_BLOCK_SIZE] += yield;
+			touched[line] = 0;
+		}
+	}
+	solved = static_cast<int>(queue.size());
+	if (queue.empty()) {
+		return true;
+	}
+
+	for (QueuedLine& queued : queue) {
+		queued.block_yield = block_yields[queued.line / LINE_BLOCK_SIZE];
+	}
+	sort(queue.begin(), queue.end(), [](const QueuedLine& a, const QueuedLine& b) {
+		if (a.block_yield != b.block_yield) {
+			return a.block_yield > b.block_yield;
+		}
+		if (a.line / LINE_BLOCK_SIZE != b.line / LINE_BLOCK_SIZE) {
+			return a.line < b.line;
+		}
+		return a.yield > b.yield;
+	});
+	block_starts.clear();
+	for (int i = 0; i < solved; i++) {
+		if (i == 0 || queue[i].line / LINE_BLOCK_SIZE != queue[i - 1].line / LINE_BLOCK_SIZE) {
+			block_starts.push_back(i);
+		}
+	}
+	int block_count = static_cast<int>(block_starts.size());
+	block_starts.push_back(solved);
+
+	phase_rows = rows;
+	next_block.store(0, memory_order_relaxed);
+	failed.store(false, memory_order_relaxed);
+
+	int job_count = 0;
+	if (pool != nullptr && static_cast<int64_t>(solved) * length >= parallel_min_spaces) {
+		job_count = min(static_cast<int>(jobs.size()), block_count - 1);
+		finished_jobs.store(0, memory_order_relaxed);
+		for (int i = 0; i < job_count; i++) {
+			jobs[i] = { &Solver::run_job, this, i };
+		}
+		pool->submit(jobs.data(), job_count);
+	}
+	work_phase(workers[0]);
+
+	// Phases are short, so waiting spins instead of sleeping
+	while (finished_jobs.load(memory_order_acquire) < job_count) {
+		this_thread::yield();
+	}
+
+	// Each thread counted what it ruled out in the other direction and logged what it cleared on its own,
+	// the counts are added up and the logs are added to the trail now that they are done
+	vector<int>& other = rows ? column_touched : row_touched;
+	for (int w = 0; w <= job_count; w++) {
+		int* counts = workers[w].touched.data();
+		for (int line = 0; line < static_cast<int>(other.size()); line++) {
+			other[line] += counts[line];
+			counts[line] = 0;
+		}
+		if (w > 0) {
+			trail.insert(trail.end(), workers[w].trail.begin(), workers[w].trail.end());
+			workers[w].trail.clear();
+		}
+	}
+	return !failed.load(memory_order_relaxed);
+}
+
+// Takes blocks of lines from the queue until it runs out or a line can't be solved
+// The calling thread logs straight into the trail, the others log into their own and are added in after the phase
+void Solver::work_phase(LineWorker& worker) {
+	vector<TrailEntry>& log = &worker == &workers[0] ? trail : worker.trail;
+	int block_count = static_cast<int>(block_starts.size()) - 1;
+	while (!failed.load(memory_order_relaxed)) {
+		int block = next_block.fetch_add(1, memory_order_relaxed);
+		if (block >= block_count) {
+			break;
+		}
+		for (int i = block_starts[block]; i < block_starts[block + 1] && !failed.load(memory_order_relaxed); i++) {
+			if (!solve_line(worker, log, phase_rows, queue[i].line)) {
+				failed.store(true, memory_order_relaxed);
+			}
+		}
+	}
+}
+
+// Job index 0 gets worker 1 since worker 0 is the thread that started the phase
+void Solver::run_job(void* data, int index, int) {
+	Solver* solver = static_cast<Solver*>(data);
+	solver->work_phase(solver->workers[index + 1]);
+	solver->finished_jobs.fetch_add(1, memory_order_release);
+}
+
+// Solves one line and clears the possibilities it ruled out from the other direction, the cleared bits are added to log
+// Only this thread writes the line's own words during the phase. The words in the other direction hold 64 lines each, which is
+// why lines are handed out in blocks of 64, and they are cleared with atomic ands so that sharing one would still be safe.
+// Line solving only ever takes possibilities away, so clearing bits is all it needs
+bool Solver::solve_line(LineWorker& worker, vector<TrailEntry>& log, bool rows, int line) {
+	int length = rows ? width : height;
+	int words = rows ? row_words : column_words;
+	int cross_words = rows ? column_words : row_words;
+	const ClueSet* clues = rows ? row_clues : column_clues;
+	atomic<uint64_t>* fill = (rows ? row_fill : column_fill) + line * colors * words;
+	atomic<uint64_t>* empty = (rows ? row_empty : column_empty) + line * words;
+	atomic<uint64_t>* cross_fill = rows ? column_fill : row_fill;
+	atomic<uint64_t>* cross_empty = rows ? column_empty : row_empty;
+
+	uint64_t* new_fill = worker.fill.data();
+	uint64_t* new_empty = worker.empty.data();
+	for (int i = 0; i < colors * words; i++) {
+		new_fill[i] = fill[i].load(memory_order_relaxed);
+	}
+	for (int i = 0; i < words; i++) {
+		new_empty[i] = empty[i].load(memory_order_relaxed);
+	}
+
+	if (!worker.line_solver.solve(length, clues->begin(line), clues->line_colors(line), clues->size(line), colors, new_fill, new_empty)) {
+		return false;
+	}
+
+	// The empty bitset is handled as one more color after the real ones
+	uint64_t keep = ~(1ull << (line % 64));
+	for (int plane = 0; plane <= colors; plane++) {
+		atomic<uint64_t>* own = plane < colors ? fill + plane * words : empty;
+		const uint64_t* solved = plane < colors ? new_fill + plane * words : new_empty;
+		for (int i = 0; i < words; i++) {
+			uint64_t removed = own[i].load(memory_order_relaxed) & ~solved[i];
+			if (removed == 0) {
+				continue;
+			}
+			own[i].store(solved[i], memory_order_relaxed);
+			if (logging) {
+				log.push_back({ static_cast<size_t>(&own[i] - state.data()), removed });
+			}
+
+			while (removed != 0) {
+				int cross = i * 64 + count_trailing_zeros(removed);
+				atomic<uint64_t>* word = plane < colors ? cross_fill + (cross * colors + plane) * cross_words : cross_empty + cross * cross_words;
+				word[line / 64].fetch_and(keep, memory_order_relaxed);
+				if (logging) {
+					log.push_back({ static_cast<size_t>(&word[line / 64] - state.data()), ~keep });
+				}
+				worker.touched[cross]++;
+				removed &= removed - 1;
+			}
+		}
+	}
+	return true;
+}
+
+// Guesses a color for the first unknown space, then tries the space without that color
+// Each guess remembers how long the trail was, so going back to it only sets the bits cleared since then again
+void Solver::search(int max_solutions) {
+	guesses.clear();
+	trail.clear();
+	logging = false;
+
+	while (true) {
+		if (++nodes > limits.nodes) {
+			gave_up = true;
+			return;
+		}
+
+		// Dead ends and solutions both go back to the last guess, solutions so that the search can look for another
+		int x;
+		int y;
+		int color;
+		bool solved = propagate();
+		if (gave_up) {
+			return;
+		}
+		if (solved && find_unknown(x, y, color)) {
+			if (static_cast<int>(guesses.size()) >= limits.depth) {
+				gave_up = true;
+				return;
+			}
+			guesses.push_back({ x, y, color, trail.size(), false });
+			logging = true;
+			set_space(x, y, color);
+			continue;
+		}
+		if (solved) {
+			solutions_found++;
+			if (solutions_found == 1) {
+				solution.resize(static_cast<size_t>(height) * colors * row_words);
+				for (size_t i = 0; i < solution.size(); i++) {
+					solution[i] = row_fill[i].load(memory_order_relaxed);
+				}
+			}
+			if (solutions_found >= max_solutions) {
+				return;
+			}
+		}
+
+		while (!guesses.empty() && guesses.back().second_try) {
+			guesses.pop_back();
+		}
+		if (guesses.empty()) {
+			return;
+		}
+
+		Guess& guess = guesses.back();
+		undo(guess.trail_size);
+		fill(row_touched.begin(), row_touched.end(), 0);
+		fill(column_touched.begin(), column_touched.end(), 0);
+		guess.second_try = true;
+		rule_out(guess.x, guess.y, guess.color);
+	}
+}
+
+// Finds the first space that still has more than one possibility and the first color it can be, returns false if there isn't one
+// A space is unknown while it still has at least two possibilities, once has the spaces with one and twice the spaces with more
+bool Solver::find_unknown(int& x, int& y, int& color) {
+	for (y = 0; y < height; y++) {
+		for (int i = 0; i < row_words; i++) {
+			uint64_t once = row_empty[y * row_words + i].load(memory_order_relaxed);
+			uint64_t twice = 0;
+			for (int plane = 0; plane < colors; plane++) {
+				uint64_t fill = row_fill[(y * colors + plane) * row_words + i].load(memory_order_relaxed);
+				twice |= once & fill;
+				once |= fill;
+			}
+			if (twice != 0) {
+				int shift = count_trailing_zeros(twice);
+				x = i * 64 + shift;
+				color = 0;
+				while (!((row_fill[(y * colors + color) * row_words + i].load(memory_order_relaxed) >> shift) & 1)) {
+					color++;
+				}
+				color++;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// Sets the bits cleared since the trail was size long again
+// Bits are only ever cleared and every clear is logged, so setting them back in any order gives the old state
+void Solver::undo(size_t size) {
+	for (size_t i = size; i < trail.size(); i++) {
+		state[trail[i].word].fetch_or(trail[i].bits, memory_order_relaxed);
+	}
+	trail.resize(size);
+}
+
+// Leaves a color (0 for empty) as the only possibility for a space
+void Solver::set_space(int x, int y, int color) {
+	for (int other = 0; other <= colors; other++) {
+		if (other != color) {
+			rule_out(x, y, other);
+		}
+	}
+}
+
+// Takes a color (0 for empty) away from the possibilities for a space in both copies of the puzzle
+void Solver::rule_out(int x, int y, int color) {
+	atomic<uint64_t>* row = color == 0 ? row_empty + y * row_words : row_fill + (y * colors + color - 1) * row_words;
+	atomic<uint64_t>* column = color == 0 ? column_empty + x * column_words : column_fill + (x * colors + color - 1) * column_words;
+	uint64_t row_bit = 1ull << (x % 64);
+	uint64_t column_bit = 1ull << (y % 64);
+	if (logging) {
+		if (row[x / 64].load(memory_order_relaxed) & row_bit) {
+			trail.push_back({ static_cast<size_t>(&row[x / 64] - state.data()), row_bit });
+		}
+		if (column[y / 64].load(memory_order_relaxed) & column_bit) {
+			trail.push_back({ static_cast<size_t>(&column[y / 64] - state.data()), column_bit });
+		}
+	}
+	row[x / 64].fetch_and(~row_bit, memory_order_relaxed);
+	column[y / 64].fetch_and(~column_bit, memory_order_relaxed);
+	row_touched[y]++;
+	column_touched[x]++;
+}
+
+// Gives every worker buffers big enough for the longest line of the loaded puzzle
+void Solver::size_workers() {
+	int words = max(row_words, column_words);
+	int lines = max(width, height);
+	for (LineWorker& worker : workers) {
+		worker.fill.resize(static_cast<size_t>(colors) * words);
+		worker.empty.resize(words);
+		worker.touched.assign(lines, 0);
+	}
+}
+
+void Solver::point_state() {
+	size_t row_lines = static_cast<size_t>(height) * row_words;
+	size_t column_lines = static_cast<size_t>(width) * column_words;
+	row_fill = state.data();
+	row_empty = row_fill + colors * row_lines;
+	column_fill = row_empty + row_lines;
+	column_empty = column_fill + colors * column_lines;
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#ifndef SOLVER_H_INCLUDED
+#define SOLVER_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Clues.h"
+#include "ThreadPool.h"
+
+namespace picross {
+	// Solves a single row or column. A line is two bitsets over its spaces, can_fill has a bit for every space that may still be filled
+	// and can_empty has a bit for every space that may still be empty. Solving removes every possibility that no placement of the hints allows
+	//
+	// Everything is done on whole words. Working from the start of the line, prefix[k] is the set of positions that the first k hints can end
+	// before (with any number of empty spaces after them), and the same is done from the end of the line. A space can be filled if some hint
+	// can cover it with both sides still possible, and it can be empty if it sits between prefix[k] and suffix[k] for some k
+	//
+	// Lines with more than one color have a can_fill bitset for each color. Hints only need a gap between them when they are the same color
+	class LineSolver {
+	public:
+		// Solves a line where every hint is color 1
+		bool solve(int length, const int* runs, int run_count, uint64_t* can_fill, uint64_t* can_empty);
+
+		// Solves the line in place, returns false if no placement of the hints fits
+		// can_fill holds a bitset for each color one after another starting with color 1, each (length + 63) / 64 words long
+		// Bits past the end of the line have to be 0
+		bool solve(int length, const int* runs, const int* colors, int run_count, int color_count, uint64_t* can_fill, uint64_t* can_empty);
+
+	private:
+		// Bitsets over positions 0 to length, position p is the boundary before space p
+		std::vector<uint64_t> prefix;
+		std::vector<uint64_t> suffix;
+		std::vector<uint64_t> starts;
+		std::vector<uint64_t> fits;
+		std::vector<uint64_t> reversed_fill;
+		std::vector<uint64_t> reversed_empty;
+		std::vector<uint64_t> temp;
+		std::vector<int> reversed_runs;
+		std::vector<int> reversed_colors;
+		std::vector<int> ones;
+
+		// Finds prefix[0] to prefix[run_count] and the possible starts of each hint for a line
+		bool forward(int length, const int* runs, const int* colors, int run_count, int color_count, const uint64_t* fill, const uint64_t* empty,
+			uint64_t* reach, uint64_t* run_starts);
+	};
+
+	// A phase is only spread over the threads when its dirty lines hold at least this many spaces all together,
+	// smaller phases finish before the other threads would have woken up
+	inline const int64_t PARALLEL_MIN_SPACES = 16384;
+
+	// Lines are handed to the threads in blocks of this many. A word in the other direction holds a space from 64 lines,
+	// so each thread clears bits in its own words and threads don't fight over them
+	inline const int LINE_BLOCK_SIZE = 64;
+
+	// How much work one call to Solver::solve can do before it gives up, so that one request can't take over a worker
+	struct SolveLimits {
+		// Guesses, including the ones that turn out to be wrong
+		int nodes = 100000;
+
+		// Wall clock time in milliseconds, 0 means there is no limit
+		int milliseconds = 0;
+
+		// Guesses that can be waiting on each other at once
+		int depth = 100000;
+
+		// Memory for undoing guesses
+		size_t trail_bytes = 256 * 1024 * 1024;
+	};
+
+	// Solves whole puzzles from their hints with line solving, and guesses (with backtracking) when line solving gets stuck
+	// The buffers are kept between puzzles so that solving puzzles no bigger than earlier ones doesn't allocate
+	//
+	// Line solving works in phases, every dirty row is solved and then every dirty column. Lines in one direction never share
+	// their own copy of a space, so a phase can be spread over threads. The copy in the other direction is shared and only ever
+	// has bits cleared, which the threads do with atomic ands, so nothing has to be locked
+	class Solver {
+	public:
+		int width;
+		int height;
+		int colors;
+
+		Solver();
+
+		Solver(const Solver&) = delete;
+		Solver& operator=(const Solver&) = delete;
+
+		// Solves lines on this many threads, counting the thread that calls solve. 1 solves everything on the calling thread
+		// Phases with fewer than min_spaces dirty spaces are still solved on the calling thread since they don't gain from it
+		void set_threads(int count, int64_t min_spaces = PARALLEL_MIN_SPACES);
+		int threads() const;
+
+		// Sets up a puzzle with every space unknown, returns false if the hints don't make a valid puzzle
+		bool load(const ClueSet& rows, const ClueSet& columns);
+
+		// Looks for up to max_solutions solutions, giving up when it runs into any of the limits
+		// Returns the number of solutions found, or -1 if it gave up first
+		int solve(int max_solutions, const SolveLimits& limits);
+
+		// Returns the color of a space in the first solution that was found, 0 if it is empty
+		int solution_color(int x, int y) const;
+
+	private:
+		// Bits that were cleared from a word of the state, setting them again undoes the change
+		struct TrailEntry {
+			size_t word;
+			uint64_t bits;
+		};
+
+		// What one thread needs to solve lines. touched counts the possibilities the thread has ruled out in each line of
+		// the other direction, the counts are added up after each phase so that the threads never share them
+		struct LineWorker {
+			LineSolver line_solver;
+			std::vector<uint64_t> fill;
+			std::vector<uint64_t> empty;
+			std::vector<int> touched;
+			std::vector<TrailEntry> trail;
+		};
+
+		// A guess that is being tried. The first try leaves the color as the only possibility for the space,
+		// the second takes it away. trail_size is where the trail was before the guess
+		struct Guess {
+			int x;
+			int y;
+			int color;
+			size_t trail_size;
+			bool second_try;
+		};
+
+		// A dirty line waiting to be solved, block_yield is the yield of every queued line in its block added up
+		struct QueuedLine {
+			int64_t block_yield;
+			int64_t yield;
+			int line;
+		};
+
+		const ClueSet* row_clues;
+		const ClueSet* column_clues;
+
+		int row_words;
+		int column_words;
+
+		// The puzzle is stored by rows and by columns so that every line can be read as packed words
+		// Each line has a fill bitset for every color followed by the next line, the empty bitsets are kept separately
+		// Both copies are kept in step whenever a space changes
+		std::vector<std::atomic<uint64_t>> state;
+		size_t state_words;
+		std::atomic<uint64_t>* row_fill;
+		std::atomic<uint64_t>* row_empty;
+		std::atomic<uint64_t>* column_fill;
+		std::atomic<uint64_t>* column_empty;
+
+		std::vector<uint64_t> solution;
+
+		// How many possibilities have been ruled out in each line since it was last solved, a line is dirty while this isn't 0
+		std::vector<int> row_touched;
+		std::vector<int> column_touched;
+
+		// How many spaces a line has left over after its hints and the gaps between them, tight lines rule out more
+		std::vector<int> row_slack;
+		std::vector<int> column_slack;
+
+		// Every bit cleared since the first open guess, in order, so that guesses can be undone without copying the state
+		// Nothing is logged while there are no guesses since those changes are never undone
+		std::vector<TrailEntry> trail;
+		std::vector<Guess> guesses;
+		bool logging;
+
+		// Worker 0 is the calling thread, the pool runs the rest
+		std::vector<LineWorker> workers;
+		std::unique_ptr<ThreadPool> pool;
+		std::vector<Job> jobs;
+
+		// The lines of the phase being solved grouped by block, block b is queue[block_starts[b]] up to queue[block_starts[b + 1]]
+		// The threads take whole blocks in order by bumping next_block
+		std::vector<QueuedLine> queue;
+		std::vector<int64_t> block_yields;
+		std::vector<int> block_starts;
+		bool phase_rows;
+		int64_t parallel_min_spaces;
+		std::atomic<int> next_block;
+		std::atomic<bool> failed;
+		std::atomic<int> finished_jobs;
+
+		int solutions_found;
+		int nodes;
+		bool gave_up;
+		SolveLimits limits;
+		std::chrono::steady_clock::time_point deadline;
+
+		// Solves dirty lines until nothing changes, returns false if a line can't be solved or a limit was reached
+		bool propagate();
+
+		// Checks the time and memory limits, sets gave_up if one was reached
+		bool over_limits();
+
+		// Solves every dirty line in one direction, solved is set to how many there were
+		// Returns false if a line can't be solved
+		bool run_phase(bool rows, int& solved);
+
+		// Takes blocks of lines from the queue until it runs out or a line can't be solved
+		void work_phase(LineWorker& worker);
+		static void run_job(void* data, int index, int worker);
+
+		// Solves one line and clears the possibilities it ruled out from the other direction, the cleared bits are added to log
+		bool solve_line(LineWorker& worker, std::vector<TrailEntry>& log, bool rows, int line);
+
+		// Guesses a color for the first unknown space, then tries the space without that color
+		// The guesses are kept on a stack instead of recursing so that long chains of guesses can't run out of thread stack
+		void search(int max_solutions);
+
+		// Finds the first space that still has more than one possibility and the first color it can be, returns false if there isn't one
+		bool find_unknown(int& x, int& y, int& color);
+
+		// Sets the bits cleared since the trail was size long again
+		void undo(size_t size);
+
+		// Leaves a color (0 for empty) as the only possibility for a space
+		void set_space(int x, int y, int color);
+
+		// Takes a color (0 for empty) away from the possibilities for a space in both copies of the puzzle
+		void rule_out(int x, int y, int color);
+
+		void size_workers();
+		void point_state();
+	};
+}
+
+#endif
\ No newline at end of file
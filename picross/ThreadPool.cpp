@@ -0,0 +1,82 @@
+#include "ThreadPool.h"
+
+using namespace std;
+using picross::ThreadPool;
+
+// Starts the workers, at least one is always started
+ThreadPool::ThreadPool(int thread_count) {
+	head = 0;
+	queued = 0;
+	stopping = false;
+	queue.resize(64);
+
+	if (thread_count < 1) {
+		thread_count = 1;
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads.emplace_back(&ThreadPool::work, this, i);
+	}
+}
+
+// Lets the workers finish the jobs that are already queued before they stop
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (thread& worker : threads) {
+		worker.join();
+	}
+}
+
+int ThreadPool::size() const {
+	return static_cast<int>(threads.size());
+}
+
+// Adds jobs to the queue, all of them are added under one lock
+// The ring doubles when it is full, the jobs are unwrapped into the start of the new ring
+void ThreadPool::submit(const Job* jobs, int count) {
+	{
+		lock_guard<mutex> guard(lock);
+		if (queued + count > queue.size()) {
+			size_t capacity = queue.size();
+			while (queued + count > capacity) {
+				capacity *= 2;
+			}
+			vector<Job> bigger(capacity);
+			for (size_t i = 0; i < queued; i++) {
+				bigger[i] = queue[(head + i) % queue.size()];
+			}
+			queue.swap(bigger);
+			head = 0;
+		}
+		for (int i = 0; i < count; i++) {
+			queue[(head + queued) % queue.size()] = jobs[i];
+			queued++;
+		}
+	}
+	if (count == 1) {
+		wake.notify_one();
+	}
+	else {
+		wake.notify_all();
+	}
+}
+
+void ThreadPool::work(int worker) {
+	while (true) {
+		Job job;
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [this] { return queued > 0 || stopping; });
+			if (queued == 0) {
+				return;
+			}
+			job = queue[head];
+			head = (head + 1) % queue.size();
+			queued--;
+		}
+		job.run(job.data, job.index, worker);
+	}
+}
\ No newline at end of file
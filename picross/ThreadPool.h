@@ -0,0 +1,50 @@
+#ifndef THREAD_POOL_H_INCLUDED
+#define THREAD_POOL_H_INCLUDED
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace picross {
+	// A piece of work for the pool. run is called with the data and index of the job and the number of the worker running it,
+	// so a job can use buffers that belong to its worker without locking them
+	struct Job {
+		void (*run)(void* data, int index, int worker);
+		void* data;
+		int index;
+	};
+
+	// A fixed set of worker threads that take jobs from one queue
+	// Jobs are plain structs in a ring buffer, so adding them doesn't allocate once the ring has grown to fit
+	class ThreadPool {
+	public:
+		// Starts the workers, at least one is always started
+		explicit ThreadPool(int thread_count);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// The number of workers, workers are numbered from 0 to size() - 1
+		int size() const;
+
+		// Adds jobs to the queue, all of them are added under one lock
+		void submit(const Job* jobs, int count);
+
+	private:
+		std::vector<std::thread> threads;
+
+		std::vector<Job> queue;
+		size_t head;
+		size_t queued;
+
+		std::mutex lock;
+		std::condition_variable wake;
+		bool stopping;
+
+		void work(int worker);
+	};
+}
+
+#endif
\ No newline at end of file
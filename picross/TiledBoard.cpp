@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Bits.h"
+#include "TiledBoard.h"
+
+using namespace std;
+using picross::TilePool;
+using picross::TiledBoard;
+
+// Every tile that has nothing in it points here. It is never written to, a real tile is allocated first
+// It is as big as the biggest tile so that boards with any number of colors can read from it
+static uint64_t empty_tile[picross::MAX_TILE_PLANES * picross::TILE_SIZE] = {};
+
+// The number of tiles each new block of the pool holds, blocks grow as the board uses more tiles
+static const size_t FIRST_BLOCK_TILES = 16;
+static const size_t MAX_BLOCK_TILES = 1024;
+
+TilePool::TilePool(size_t tile_words) :tile_words{ tile_words }, block_tiles{ FIRST_BLOCK_TILES }, used{ 0 } {}
+
+// Changes the size of the tiles that are handed out, every tile has to have been given back first
+// The blocks are thrown away since they are cut up for the old size
+void TilePool::reset(size_t new_tile_words) {
+	if (new_tile_words == tile_words) {
+		return;
+	}
+	blocks.clear();
+	free_tiles.clear();
+	tile_words = new_tile_words;
+	block_tiles = FIRST_BLOCK_TILES;
+}
+
+// Returns a tile with every space empty
+uint64_t* TilePool::allocate() {
+	if (free_tiles.empty()) {
+		blocks.emplace_back(new uint64_t[block_tiles * tile_words]);
+		uint64_t* block = blocks.back().get();
+
+		// The tiles are handed out from the front of the block first
+		for (size_t i = block_tiles; i > 0; i--) {
+			free_tiles.push_back(block + (i - 1) * tile_words);
+		}
+
+		if (block_tiles < MAX_BLOCK_TILES) {
+			block_tiles *= 2;
+		}
+	}
+
+	uint64_t* tile = free_tiles.back();
+	free_tiles.pop_back();
+	memset(tile, 0, tile_words * sizeof(uint64_t));
+	used++;
+
+	return tile;
+}
+
+// Gives a tile back to the pool so it can be reused
+void TilePool::release(uint64_t* tile) {
+	free_tiles.push_back(tile);
+	used--;
+}
+
+size_t TilePool::used_tiles() const {
+	return used;
+}
+
+size_t TilePool::reserved_bytes() const {
+	return (used + free_tiles.size()) * tile_words * sizeof(uint64_t);
+}
+
+TiledBoard::TiledBoard() :TiledBoard(0, 0) {}
+
+TiledBoard::TiledBoard(int width, int height, int colors) :width{ 0 }, height{ 0 }, tile_columns{ 0 }, tile_rows{ 0 }, colors{ 1 },
+	pool{ 3 * TILE_SIZE } {
+	resize(width, height, colors);
+}
+
+// Changes the size and number of colors of the board, this also empties the board
+void TiledBoard::resize(int new_width, int new_height, int new_colors) {
+	clear();
+
+	colors = new_colors;
+	pool.reset(static_cast<size_t>(plane_count()) * TILE_SIZE);
+
+	width = new_width;
+	height = new_height;
+	tile_columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+	tile_rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+	tiles.assign(static_cast<size_t>(tile_columns) * tile_rows, empty_tile);
+	tile_counts.assign(tiles.size(), 0);
+}
+
+// Empties the board and gives all of its tiles back to the pool
+void TiledBoard::clear() {
+	for (size_t i = 0; i < tiles.size(); i++) {
+		if (tiles[i] != empty_tile) {
+			pool.release(tiles[i]);
+			tiles[i] = empty_tile;
+			tile_counts[i] = 0;
+		}
+	}
+}
+
+// Makes this board the same size as the other board with the same spaces
+// Only the tiles that are used on the other board are copied
+void TiledBoard::copy_from(const TiledBoard& other) {
+	if (this == &other) {
+		return;
+	}
+
+	resize(other.width, other.height, other.colors);
+
+	for (size_t i = 0; i < tiles.size(); i++) {
+		if (other.tiles[i] != empty_tile) {
+			tiles[i] = pool.allocate();
+			memcpy(tiles[i], other.tiles[i], plane_count() * TILE_SIZE * sizeof(uint64_t));
+			tile_counts[i] = other.tile_counts[i];
+		}
+	}
+}
+
+// The number of planes in each tile
+int TiledBoard::plane_count() const {
+	return colors + 2;
+}
+
+// Returns the state of a space, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer, 4 and up are the other colors
+int TiledBoard::get(int x, int y) const {
+	const uint64_t* tile = tiles[tile_index(x, y)];
+	if (tile == empty_tile) {
+		return 0;
+	}
+
+	int word = y % TILE_SIZE;
+	int bit = x % TILE_SIZE;
+	for (int plane = 0; plane < plane_count(); plane++) {
+		if ((tile[plane * TILE_SIZE + word] >> bit) & 1) {
+			return plane + 1;
+		}
+	}
+	return 0;
+}
+
+// Sets the state of a space, the tile is only allocated once something that isn't empty is put in it
+// Tiles that become completely empty again are given back to the pool
+void TiledBoard::set(int x, int y, int state) {
+	int index = tile_index(x, y);
+	uint64_t* tile = tiles[index];
+
+	if (tile == empty_tile) {
+		if (state == 0) {
+			return;
+		}
+		tile = pool.allocate();
+		tiles[index] = tile;
+	}
+
+	int word = y % TILE_SIZE;
+	uint64_t mask = uint64_t(1) << (x % TILE_SIZE);
+
+	bool was_empty = true;
+	for (int plane = 0; plane < plane_count(); plane++) {
+		uint64_t& row = tile[plane * TILE_SIZE + word];
+		if (row & mask) {
+			was_empty = false;
+		}
+		if (plane + 1 == state) {
+			row |= mask;
+		}
+		else {
+			row &= ~mask;
+		}
+	}
+
+	if (was_empty && state != 0) {
+		tile_counts[index]++;
+	}
+	else if (!was_empty && state == 0) {
+		tile_counts[index]--;
+		if (tile_counts[index] == 0) {
+			pool.release(tile);
+			tiles[index] = empty_tile;
+		}
+	}
+}
+
+// Returns 64 spaces of a row as bits, bit i is set if the space at (tile_column * TILE_SIZE + i, y) is in the plane
+uint64_t TiledBoard::row_word(int plane, int tile_column, int y) const {
+	return tiles[(y / TILE_SIZE) * tile_columns + tile_column][plane * TILE_SIZE + y % TILE_SIZE];
+}
+
+// Puts up to 64 spaces of a row in a plane at once, the spaces with their bit set are taken out of the other planes
+// Spaces with their bit clear are left alone and bits past the right edge of the board are ignored
+void TiledBoard::set_row_word(int plane, int tile_column, int y, uint64_t word) {
+	int edge = width - tile_column * TILE_SIZE;
+	if (edge < TILE_SIZE) {
+		word &= (uint64_t(1) << edge) - 1;
+	}
+
+	int index = (y / TILE_SIZE) * tile_columns + tile_column;
+	uint64_t* tile = tiles[index];
+	if (tile == empty_tile) {
+		if (word == 0) {
+			return;
+		}
+		tile = pool.allocate();
+		tiles[index] = tile;
+	}
+
+	int row = y % TILE_SIZE;
+	int planes = plane_count();
+	uint64_t old_used = 0;
+	for (int i = 0; i < planes; i++) {
+		uint64_t& plane_row = tile[i * TILE_SIZE + row];
+		old_used |= plane_row;
+		plane_row = (i == plane) ? (plane_row | word) : (plane_row & ~word);
+	}
+
+	uint64_t new_used = old_used | word;
+	tile_counts[index] += static_cast<uint16_t>(picross::count_bits(new_used) - picross::count_bits(old_used));
+}
+
+// Returns 64 spaces of a column as bits, bit i is set if the space at (x, tile_row * TILE_SIZE + i) is in the plane
+uint64_t TiledBoard::column_word(int plane, int x, int tile_row) const {
+	const uint64_t* tile = tiles[tile_row * tile_columns + x / TILE_SIZE];
+	if (tile == empty_tile) {
+		return 0;
+	}
+
+	const uint64_t* rows = tile + plane * TILE_SIZE;
+	int bit = x % TILE_SIZE;
+	uint64_t column = 0;
+	for (int i = 0; i < TILE_SIZE; i++) {
+		column |= ((rows[i] >> bit) & 1) << i;
+	}
+	return column;
+}
+
+// Returns the TILE_SIZE row words of one plane of a tile
+const uint64_t* TiledBoard::tile_plane(int plane, int tile_column, int tile_row) const {
+	return tiles[tile_row * tile_columns + tile_column] + plane * TILE_SIZE;
+}
+
+// Checks if a tile has nothing in it, empty tiles can be skipped when iterating
+bool TiledBoard::tile_empty(int tile_column, int tile_row) const {
+	return tiles[tile_row * tile_columns + tile_column] == empty_tile;
+}
+
+// Counts the spaces in a plane
+int TiledBoard::count(int plane) const {
+	int total = 0;
+	for (const uint64_t* tile : tiles) {
+		if (tile == empty_tile) {
+			continue;
+		}
+		for (int i = 0; i < TILE_SIZE; i++) {
+			total += picross::count_bits(tile[plane * TILE_SIZE + i]);
+		}
+	}
+	return total;
+}
+
+// Counts the spaces that have any color
+int TiledBoard::count_colored() const {
+	int total = 0;
+	for (int color = 1; color <= colors; color++) {
+		total += count(color_plane(color));
+	}
+	return total;
+}
+
+// Checks if a plane is the same on both boards, the boards have to be the same size
+// Whole words are compared at once and tiles that are empty on both boards are skipped
+bool TiledBoard::plane_equal(const TiledBoard& other, int plane) const {
+	for (size_t i = 0; i < tiles.size(); i++) {
+		if (tiles[i] == empty_tile && other.tiles[i] == empty_tile) {
+			continue;
+		}
+		if (memcmp(tiles[i] + plane * TILE_SIZE, other.tiles[i] + plane * TILE_SIZE, TILE_SIZE * sizeof(uint64_t)) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Checks if every color plane is the same on both boards, x's and spacers don't matter
+// A color that only one of the boards has has to be empty on that board
+bool TiledBoard::colors_equal(const TiledBoard& other) const {
+	int most_colors = max(colors, other.colors);
+	for (size_t i = 0; i < tiles.size(); i++) {
+		if (tiles[i] == empty_tile && other.tiles[i] == empty_tile) {
+			continue;
+		}
+		for (int color = 1; color <= most_colors; color++) {
+			const uint64_t* plane = color <= colors ? tiles[i] + color_plane(color) * TILE_SIZE : empty_tile;
+			const uint64_t* other_plane = color <= other.colors ? other.tiles[i] + color_plane(color) * TILE_SIZE : empty_tile;
+			if (memcmp(plane, other_plane, TILE_SIZE * sizeof(uint64_t)) != 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// The number of tiles that have been allocated for this board
+size_t TiledBoard::used_tiles() const {
+	return pool.used_tiles();
+}
+
+// The number of bytes this board is using, including its tile pointers
+size_t TiledBoard::memory_usage() const {
+	return pool.reserved_bytes() + tiles.capacity() * sizeof(uint64_t*) + tile_counts.capacity() * sizeof(uint16_t);
+}
+
+// Returns the index of the tile holding the space
+int TiledBoard::tile_index(int x, int y) const {
+	return (y / TILE_SIZE) * tile_columns + x / TILE_SIZE;
+}
\ No newline at end of file
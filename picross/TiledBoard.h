@@ -0,0 +1,152 @@
+#ifndef TILED_BOARD_H_INCLUDED
+#define TILED_BOARD_H_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace picross {
+	// Boards are split into square tiles, a tile row of 64 spaces fits in a single 64 bit word
+	inline const int TILE_SIZE = 64;
+
+	// The widest or tallest board the game supports, boards from the command line, traces and daemon requests are kept to this size
+	inline const int MAX_BOARD_SIDE = 10000;
+
+	// The most colors a board can have
+	inline const int MAX_COLORS = 8;
+
+	// A tile has one bitplane for each state that isn't empty. Plane 0 holds spaces filled with color 1 (state 1), plane 1 holds x's (state 2),
+	// plane 2 holds spacers (state 3) and the planes after that hold colors 2 and up (state 4 and up), so the plane for a state is always state - 1
+	// A board with one color has 3 planes, which is the same as boards had before there were colors
+	inline const int MAX_TILE_PLANES = MAX_COLORS + 2;
+
+	// Colors are numbered from 1, 0 is used for a space without a color
+	inline int color_state(int color) {
+		return color == 1 ? 1 : color + 2;
+	}
+
+	inline int state_color(int state) {
+		return state == 1 ? 1 : state >= 4 ? state - 2 : 0;
+	}
+
+	inline int color_plane(int color) {
+		return color_state(color) - 1;
+	}
+
+	// Hands out tiles from large blocks so that boards don't need an allocation for every tile they touch
+	// Released tiles are kept and handed out again before a new block is made
+	class TilePool {
+	public:
+		explicit TilePool(size_t tile_words);
+
+		// Changes the size of the tiles that are handed out, every tile has to have been given back first
+		void reset(size_t new_tile_words);
+
+		// Returns a tile with every space empty
+		uint64_t* allocate();
+
+		// Gives a tile back to the pool so it can be reused
+		void release(uint64_t* tile);
+
+		// The number of tiles that are currently handed out
+		size_t used_tiles() const;
+
+		// The number of bytes the pool has taken from the system
+		size_t reserved_bytes() const;
+
+	private:
+		std::vector<std::unique_ptr<uint64_t[]>> blocks;
+		std::vector<uint64_t*> free_tiles;
+		size_t tile_words;
+		size_t block_tiles;
+		size_t used;
+	};
+
+	// Stores a board as tiles of bitplanes. Tiles that have never had anything put in them all point to one shared empty tile,
+	// so a fresh board only takes up the space for its tile pointers and grows only with the area that is actually used
+	class TiledBoard {
+	public:
+		int width;
+		int height;
+
+		// The number of tiles across and down the board, the tiles on the right and bottom edges may only be partly used
+		int tile_columns;
+		int tile_rows;
+
+		// The number of colors spaces can be filled with, the number of planes in each tile is colors + 2
+		int colors;
+
+		TiledBoard();
+		TiledBoard(int width, int height, int colors = 1);
+
+		// Tiles point into this board's pool, so boards are copied with copy_from instead
+		TiledBoard(const TiledBoard&) = delete;
+		TiledBoard& operator=(const TiledBoard&) = delete;
+
+		// Changes the size and number of colors of the board, this also empties the board
+		void resize(int new_width, int new_height, int new_colors = 1);
+
+		// Empties the board and gives all of its tiles back to the pool
+		void clear();
+
+		// Makes this board the same size as the other board with the same spaces
+		void copy_from(const TiledBoard& other);
+
+		// The number of planes in each tile
+		int plane_count() const;
+
+		// Returns the state of a space, 0 is an empty space, 1 is a filled space, 2 is an x, 3 is a spacer, 4 and up are the other colors
+		int get(int x, int y) const;
+
+		// Sets the state of a space, the tile is only allocated once something that isn't empty is put in it
+		void set(int x, int y, int state);
+
+		// Returns 64 spaces of a row as bits, bit i is set if the space at (tile_column * TILE_SIZE + i, y) is in the plane
+		uint64_t row_word(int plane, int tile_column, int y) const;
+
+		// Puts up to 64 spaces of a row in a plane at once, the spaces with their bit set are taken out of the other planes
+		// Spaces with their bit clear are left alone and bits past the right edge of the board are ignored
+		void set_row_word(int plane, int tile_column, int y, uint64_t word);
+
+		// Returns 64 spaces of a column as bits, bit i is set if the space at (x, tile_row * TILE_SIZE + i) is in the plane
+		uint64_t column_word(int plane, int x, int tile_row) const;
+
+		// Returns the TILE_SIZE row words of one plane of a tile
+		const uint64_t* tile_plane(int plane, int tile_column, int tile_row) const;
+
+		// Checks if a tile has nothing in it, empty tiles can be skipped when iterating
+		bool tile_empty(int tile_column, int tile_row) const;
+
+		// Counts the spaces in a plane
+		int count(int plane) const;
+
+		// Counts the spaces that have any color
+		int count_colored() const;
+
+		// Checks if a plane is the same on both boards, the boards have to be the same size
+		bool plane_equal(const TiledBoard& other, int plane) const;
+
+		// Checks if every color plane is the same on both boards, x's and spacers don't matter
+		// The boards have to be the same size, but they don't need the same number of colors
+		bool colors_equal(const TiledBoard& other) const;
+
+		// The number of tiles that have been allocated for this board
+		size_t used_tiles() const;
+
+		// The number of bytes this board is using, including its tile pointers
+		size_t memory_usage() const;
+
+	private:
+		std::vector<uint64_t*> tiles;
+
+		// Counts how many spaces in each tile aren't empty so the tile can be released once it empties again
+		std::vector<uint16_t> tile_counts;
+
+		TilePool pool;
+
+		// Returns the index of the tile holding the space
+		int tile_index(int x, int y) const;
+	};
+}
+
+#endif
\ No newline at end of file
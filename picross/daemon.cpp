@@ -0,0 +1,358 @@
+// Headless puzzle daemon for checking, solving and making puzzles without the game
+// Listens on a Unix domain socket or a loopback TCP port. Every complete line that has arrived on a connection is answered as one batch,
+// the requests in a batch are spread over a thread pool and the responses are written back in order with one write
+// --solver-threads spreads each big SOLVE or UNIQUE over more threads of its own, which helps when a few huge puzzles
+// are sent instead of many small ones
+// See Protocol.h for the requests
+// Usage: picross_daemon [--unix <path> | --port <port>] [--threads <count>] [--solver-threads <count>] [--node-limit <guesses>] [--time-limit <ms>]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Protocol.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+using picross::Job;
+using picross::RequestContext;
+using picross::RequestKind;
+using picross::SolveLimits;
+using picross::ThreadPool;
+
+// The port used when no socket is given
+const int DEFAULT_PORT = 7453;
+
+// How long SOLVE and UNIQUE can take before they give up when no time limit is given, so one hard puzzle can't hold a worker for long
+const int DEFAULT_TIME_LIMIT_MS = 2000;
+
+// A connection is closed if it sends this much without finishing a line, the largest request is a bit over 16MB
+const size_t MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+// Latencies are counted in buckets of powers of two microseconds, bucket b holds latencies under 2^b microseconds
+const int LATENCY_BUCKETS = 40;
+
+// The counters are only ever added to, so relaxed atomics are enough and workers never wait on each other to count
+struct DaemonStats {
+	atomic<uint64_t> requests[picross::REQUEST_KINDS];
+	atomic<uint64_t> batches;
+	atomic<uint64_t> connections;
+	atomic<uint64_t> busy_nanoseconds;
+	atomic<uint64_t> latency_buckets[LATENCY_BUCKETS];
+	chrono::steady_clock::time_point started;
+};
+
+// A request line waiting in a batch and the response it gets
+struct Slot {
+	const char* line;
+	size_t length;
+	string response;
+};
+
+// Everything a connection keeps between batches, so that a connection sending batches of the same size doesn't allocate
+struct Connection {
+	int socket;
+	string input;
+	string output;
+	vector<Slot> slots;
+	vector<Job> jobs;
+
+	atomic<int> remaining;
+	mutex lock;
+	condition_variable finished;
+	bool done;
+};
+
+DaemonStats stats;
+ThreadPool* pool;
+vector<RequestContext>* contexts;
+SolveLimits limits;
+
+// Returns the bucket for a latency, the bucket is the number of bits in the latency in microseconds
+int latency_bucket(uint64_t nanoseconds) {
+	uint64_t microseconds = nanoseconds / 1000;
+	int bucket = 0;
+	while (microseconds != 0 && bucket < LATENCY_BUCKETS - 1) {
+		microseconds >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+// Returns the upper bound (in microseconds) of the bucket that a percentile (as a decimal) of the counted latencies falls in
+uint64_t latency_percentile(const uint64_t* buckets, uint64_t total, double percent) {
+	uint64_t target = static_cast<uint64_t>(percent * total);
+	uint64_t seen = 0;
+	for (int b = 0; b < LATENCY_BUCKETS; b++) {
+		seen += buckets[b];
+		if (seen > target) {
+			return 1ull << b;
+		}
+	}
+	return 1ull << (LATENCY_BUCKETS - 1);
+}
+
+void write_stats(string& response) {
+	uint64_t buckets[LATENCY_BUCKETS];
+	uint64_t counted = 0;
+	for (int b = 0; b < LATENCY_BUCKETS; b++) {
+		buckets[b] = stats.latency_buckets[b].load(memory_order_relaxed);
+		counted += buckets[b];
+	}
+
+	uint64_t total = 0;
+	response.append(" OK");
+	for (int kind = 0; kind < picross::REQUEST_KINDS; kind++) {
+		uint64_t count = stats.requests[kind].load(memory_order_relaxed);
+		total += count;
+		char buffer[64];
+		int length = snprintf(buffer, sizeof(buffer), " %s=%llu", picross::REQUEST_NAMES[kind], static_cast<unsigned long long>(count));
+		response.append(buffer, length);
+	}
+
+	double uptime = chrono::duration<double>(chrono::steady_clock::now() - stats.started).count();
+	char buffer[320];
+	int length = snprintf(buffer, sizeof(buffer), " requests=%llu batches=%llu connections=%llu uptime_s=%.3f requests_per_s=%.1f busy_ms=%.3f p50_us<=%llu p99_us<=%llu",
+		static_cast<unsigned long long>(total), static_cast<unsigned long long>(stats.batches.load(memory_order_relaxed)),
+		static_cast<unsigned long long>(stats.connections.load(memory_order_relaxed)), uptime, uptime > 0 ? total / uptime : 0.0,
+		stats.busy_nanoseconds.load(memory_order_relaxed) / 1e6,
+		static_cast<unsigned long long>(latency_percentile(buckets, counted, 0.5)), static_cast<unsigned long long>(latency_percentile(buckets, counted, 0.99)));
+	response.append(buffer, length);
+}
+
+// Runs on a worker, answers one request of a batch and wakes the connection once the whole batch is answered
+void run_request(void* data, int index, int worker) {
+	Connection* connection = static_cast<Connection*>(data);
+	Slot& slot = connection->slots[index];
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	slot.response.clear();
+	RequestKind kind = picross::handle_request(slot.line, slot.length, (*contexts)[worker], limits, slot.response);
+	if (kind == picross::REQUEST_STATS) {
+		write_stats(slot.response);
+	}
+	uint64_t latency = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+	stats.requests[kind].fetch_add(1, memory_order_relaxed);
+	stats.busy_nanoseconds.fetch_add(latency, memory_order_relaxed);
+	stats.latency_buckets[latency_bucket(latency)].fetch_add(1, memory_order_relaxed);
+
+	if (connection->remaining.fetch_sub(1, memory_order_acq_rel) == 1) {
+		lock_guard<mutex> guard(connection->lock);
+		connection->done = true;
+		connection->finished.notify_one();
+	}
+}
+
+bool send_all(int socket, const char* data, size_t length) {
+	while (length > 0) {
+		ssize_t sent = send(socket, data, length, MSG_NOSIGNAL);
+		if (sent <= 0) {
+			return false;
+		}
+		data += sent;
+		length -= sent;
+	}
+	return true;
+}
+
+// Answers every complete line in the input as one batch, returns false if the responses couldn't be sent
+bool run_batch(Connection& connection, size_t end) {
+	int count = 0;
+	size_t position = 0;
+	while (position <= end) {
+		size_t newline = connection.input.find('\n', position);
+		size_t length = newline - position;
+		const char* line = connection.input.data() + position;
+		while (length > 0 && line[length - 1] == '\r') {
+			length--;
+		}
+
+		// Blank lines are skipped so that a request can be typed by hand without getting an error for every extra enter
+		if (length > 0) {
+			if (connection.slots.size() <= static_cast<size_t>(count)) {
+				connection.slots.resize(count + 1);
+				connection.jobs.resize(count + 1);
+			}
+			connection.slots[count].line = line;
+			connection.slots[count].length = length;
+			connection.jobs[count] = { run_request, &connection, count };
+			count++;
+		}
+		position = newline + 1;
+	}
+	if (count == 0) {
+		return true;
+	}
+
+	connection.remaining.store(count, memory_order_relaxed);
+	connection.done = false;
+	pool->submit(connection.jobs.data(), count);
+	{
+		unique_lock<mutex> guard(connection.lock);
+		connection.finished.wait(guard, [&connection] { return connection.done; });
+	}
+	stats.batches.fetch_add(1, memory_order_relaxed);
+
+	connection.output.clear();
+	for (int i = 0; i < count; i++) {
+		connection.output.append(connection.slots[i].response);
+		connection.output.push_back('\n');
+	}
+	return send_all(connection.socket, connection.output.data(), connection.output.size());
+}
+
+void serve(int socket) {
+	stats.connections.fetch_add(1, memory_order_relaxed);
+	Connection connection;
+	connection.socket = socket;
+
+	vector<char> chunk(64 * 1024);
+	while (true) {
+		ssize_t received = recv(socket, chunk.data(), chunk.size(), 0);
+		if (received <= 0) {
+			break;
+		}
+		connection.input.append(chunk.data(), received);
+
+		size_t end = connection.input.rfind('\n');
+		if (end == string::npos) {
+			if (connection.input.size() > MAX_PENDING_BYTES) {
+				break;
+			}
+			continue;
+		}
+		if (!run_batch(connection, end)) {
+			break;
+		}
+		connection.input.erase(0, end + 1);
+	}
+	close(socket);
+}
+
+// Opens the socket that connections are accepted on, returns -1 if it can't be opened
+int open_listener(const char* unix_path, int port) {
+	int listener;
+	if (unix_path != nullptr) {
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		if (strlen(unix_path) >= sizeof(address.sun_path)) {
+			fprintf(stderr, "The socket path %s is too long\n", unix_path);
+			return -1;
+		}
+		strcpy(address.sun_path, unix_path);
+		unlink(unix_path);
+
+		listener = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+			perror("bind");
+			return -1;
+		}
+	}
+	else {
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		listener = socket(AF_INET, SOCK_STREAM, 0);
+		int yes = 1;
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+		if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+			perror("bind");
+			return -1;
+		}
+	}
+
+	if (listen(listener, 64) < 0) {
+		perror("listen");
+		return -1;
+	}
+	return listener;
+}
+
+int main(int argc, char* argv[]) {
+	const char* unix_path = nullptr;
+	int port = DEFAULT_PORT;
+	int thread_count = max(static_cast<int>(thread::hardware_concurrency()), 1);
+	int solver_threads = 1;
+	limits.milliseconds = DEFAULT_TIME_LIMIT_MS;
+
+	for (int i = 1; i < argc; i++) {
+		bool has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--unix") == 0 && has_value) {
+			unix_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--port") == 0 && has_value) {
+			port = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+			thread_count = max(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--solver-threads") == 0 && has_value) {
+			solver_threads = max(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--node-limit") == 0 && has_value) {
+			limits.nodes = max(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--time-limit") == 0 && has_value) {
+			limits.milliseconds = max(atoi(argv[++i]), 0);
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--unix <path> | --port <port>] [--threads <count>] [--solver-threads <count>] [--node-limit <guesses>] [--time-limit <ms>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+	int listener = open_listener(unix_path, port);
+	if (listener < 0) {
+		return 1;
+	}
+
+	stats.started = chrono::steady_clock::now();
+	vector<RequestContext> worker_contexts(thread_count);
+	for (RequestContext& context : worker_contexts) {
+		context.solver.set_threads(solver_threads);
+	}
+	contexts = &worker_contexts;
+	ThreadPool workers(thread_count);
+	pool = &workers;
+
+	if (unix_path != nullptr) {
+		printf("listening on %s with %d threads\n", unix_path, thread_count);
+	}
+	else {
+		printf("listening on 127.0.0.1:%d with %d threads\n", port, thread_count);
+	}
+	fflush(stdout);
+
+	while (true) {
+		int client = accept(listener, nullptr, nullptr);
+		if (client < 0) {
+			continue;
+		}
+		if (unix_path == nullptr) {
+			int yes = 1;
+			setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+		}
+		thread(serve, client).detach();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,311 @@
+// Load generator for the puzzle daemon
+// Makes a set of puzzles, then has several connections send them to the daemon as pipelined batches and reports the throughput and latency
+// Usage: picross_load [--unix <path> | --port <port>] [--connections <count>] [--batches <count>] [--batch <requests>]
+//                     [--size <spaces>] [--mix verify|solve|unique|generate|all]
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Clues.h"
+#include "Globals.h"
+#include "Protocol.h"
+#include "TiledBoard.h"
+
+using namespace std;
+
+using picross::ClueSet;
+using picross::TiledBoard;
+
+// The number of different puzzles the requests are made from
+const int PUZZLE_COUNT = 64;
+
+struct Options {
+	const char* unix_path = nullptr;
+	int port = 7453;
+	int connections = 4;
+	int batches = 200;
+	int batch = 64;
+	int size = 20;
+	string mix = "all";
+};
+
+// What one connection saw, the batch latencies are in microseconds
+struct ConnectionResult {
+	vector<double> latencies;
+	long long responses = 0;
+	long long errors = 0;
+	bool failed = false;
+};
+
+// Returns the value at a percentile (as a decimal) of sorted samples
+double percentile(const vector<double>& sorted, double percent) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t index = static_cast<size_t>(percent * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+int connect_to_daemon(const Options& options) {
+	int connection;
+	if (options.unix_path != nullptr) {
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		strncpy(address.sun_path, options.unix_path, sizeof(address.sun_path) - 1);
+		connection = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (connection < 0 || connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+			return -1;
+		}
+	}
+	else {
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(options.port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		connection = socket(AF_INET, SOCK_STREAM, 0);
+		if (connection < 0 || connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+			return -1;
+		}
+		int yes = 1;
+		setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+	}
+	return connection;
+}
+
+bool send_all(int connection, const string& data) {
+	size_t position = 0;
+	while (position < data.size()) {
+		ssize_t sent = send(connection, data.data() + position, data.size() - position, MSG_NOSIGNAL);
+		if (sent <= 0) {
+			return false;
+		}
+		position += sent;
+	}
+	return true;
+}
+
+// Reads until count whole lines have arrived, the lines are left in lines
+bool receive_lines(int connection, int count, string& lines) {
+	lines.clear();
+	int found = 0;
+	char chunk[64 * 1024];
+	while (found < count) {
+		ssize_t received = recv(connection, chunk, sizeof(chunk), 0);
+		if (received <= 0) {
+			return false;
+		}
+		found += static_cast<int>(count_if(chunk, chunk + received, [](char c) { return c == '\n'; }));
+		lines.append(chunk, received);
+	}
+	return true;
+}
+
+// Sends a batch and reads until count whole lines have arrived, the lines are left in lines
+// The daemon starts answering before the whole batch has arrived, so responses are read while the batch is still being sent.
+// Otherwise a big batch with big answers fills both socket buffers and both sides wait on send forever
+bool exchange_batch(int connection, const string& batch, int count, string& lines) {
+	lines.clear();
+	size_t position = 0;
+	int found = 0;
+	char chunk[64 * 1024];
+	while (found < count) {
+		pollfd ready = { connection, static_cast<short>(POLLIN | (position < batch.size() ? POLLOUT : 0)), 0 };
+		if (poll(&ready, 1, -1) < 0) {
+			return false;
+		}
+		if (ready.revents & (POLLERR | POLLNVAL)) {
+			return false;
+		}
+		if (ready.revents & POLLOUT) {
+			ssize_t sent = send(connection, batch.data() + position, batch.size() - position, MSG_NOSIGNAL | MSG_DONTWAIT);
+			if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+				return false;
+			}
+			position += max(sent, static_cast<ssize_t>(0));
+		}
+		if (ready.revents & (POLLIN | POLLHUP)) {
+			ssize_t received = recv(connection, chunk, sizeof(chunk), MSG_DONTWAIT);
+			if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+				return false;
+			}
+			if (received > 0) {
+				found += static_cast<int>(count_if(chunk, chunk + received, [](char c) { return c == '\n'; }));
+				lines.append(chunk, received);
+			}
+		}
+	}
+	return true;
+}
+
+// Makes the requests that the connections take turns sending, a request has no id or newline yet
+// Verify requests send the puzzle's own solution for half of the puzzles and a board with one space flipped for the rest
+vector<string> make_requests(const Options& options) {
+	vector<string> requests;
+	TiledBoard board;
+	ClueSet rows;
+	ClueSet columns;
+
+	for (int i = 0; i < PUZZLE_COUNT; i++) {
+		picross::generate_puzzle(options.size, options.size, globals::PERCENT_CORRECT, 1000 + i, board);
+		picross::extract_clues(board, 0, rows, columns);
+
+		string size = to_string(options.size) + " " + to_string(options.size);
+		string hints;
+		picross::format_clues(rows, hints);
+		hints.push_back(' ');
+		picross::format_clues(columns, hints);
+
+		string bits;
+		picross::format_bits(board, bits);
+		if (i % 2 == 1) {
+			bits[i % bits.size()] ^= 1;
+		}
+
+		bool all = options.mix == "all";
+		if (all || options.mix == "verify") {
+			requests.push_back("VERIFY " + size + " " + hints + " " + bits);
+		}
+		if (all || options.mix == "solve") {
+			requests.push_back("SOLVE " + size + " " + hints);
+		}
+		if (all || options.mix == "unique") {
+			requests.push_back("UNIQUE " + size + " " + hints);
+		}
+		if (all || options.mix == "generate") {
+			requests.push_back("GENERATE " + size + " " + to_string(i));
+		}
+	}
+	return requests;
+}
+
+void run_connection(const Options& options, const vector<string>& requests, int number, ConnectionResult& result) {
+	int connection = connect_to_daemon(options);
+	if (connection < 0) {
+		result.failed = true;
+		return;
+	}
+
+	string batch;
+	string lines;
+	size_t next = number;
+	result.latencies.reserve(options.batches);
+	for (int b = 0; b < options.batches; b++) {
+		batch.clear();
+		for (int i = 0; i < options.batch; i++) {
+			batch.append(to_string(b * options.batch + i));
+			batch.push_back(' ');
+			batch.append(requests[next % requests.size()]);
+			batch.push_back('\n');
+			next++;
+		}
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if (!exchange_batch(connection, batch, options.batch, lines)) {
+			result.failed = true;
+			break;
+		}
+		chrono::steady_clock::time_point end = chrono::steady_clock::now();
+		result.latencies.push_back(chrono::duration<double, micro>(end - start).count());
+
+		result.responses += options.batch;
+		for (size_t position = lines.find(" ERROR "); position != string::npos; position = lines.find(" ERROR ", position + 1)) {
+			result.errors++;
+		}
+	}
+	close(connection);
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	for (int i = 1; i < argc; i++) {
+		bool has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--unix") == 0 && has_value) {
+			options.unix_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--port") == 0 && has_value) {
+			options.port = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--connections") == 0 && has_value) {
+			options.connections = max(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--batches") == 0 && has_value) {
+			options.batches = max(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--batch") == 0 && has_value) {
+			options.batch = max(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--size") == 0 && has_value) {
+			options.size = min(max(atoi(argv[++i]), 1), picross::MAX_BOARD_SIDE);
+		}
+		else if (strcmp(argv[i], "--mix") == 0 && has_value) {
+			options.mix = argv[++i];
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--unix <path> | --port <port>] [--connections <count>] [--batches <count>] [--batch <requests>]\n"
+				"       [--size <spaces>] [--mix verify|solve|unique|generate|all]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	vector<string> requests = make_requests(options);
+	if (requests.empty()) {
+		fprintf(stderr, "Unknown request mix %s\n", options.mix.c_str());
+		return 1;
+	}
+
+	vector<ConnectionResult> results(options.connections);
+	vector<thread> threads;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i = 0; i < options.connections; i++) {
+		threads.emplace_back(run_connection, cref(options), cref(requests), i, ref(results[i]));
+	}
+	for (thread& connection : threads) {
+		connection.join();
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	vector<double> latencies;
+	long long responses = 0;
+	long long errors = 0;
+	int failed = 0;
+	for (const ConnectionResult& result : results) {
+		latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+		responses += result.responses;
+		errors += result.errors;
+		failed += result.failed;
+	}
+	sort(latencies.begin(), latencies.end());
+
+	printf("%d connections x %d batches of %d %s requests on %dx%d boards\n", options.connections, options.batches, options.batch,
+		options.mix.c_str(), options.size, options.size);
+	printf("responses: %lld in %.3f s (%.0f requests/s), errors: %lld, failed connections: %d\n", responses, seconds,
+		seconds > 0 ? responses / seconds : 0.0, errors, failed);
+	printf("batch latency: p50 %.1f us, p99 %.1f us, max %.1f us\n", percentile(latencies, 0.5), percentile(latencies, 0.99),
+		latencies.empty() ? 0.0 : latencies.back());
+
+	int connection = connect_to_daemon(options);
+	string lines;
+	if (connection >= 0 && send_all(connection, "stats STATS\n") && receive_lines(connection, 1, lines)) {
+		printf("daemon: %s", lines.c_str());
+	}
+	if (connection >= 0) {
+		close(connection);
+	}
+	return failed > 0 ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+// Headless replayer for recorded sessions
+// Feeds every input from a trace through the same input handling as the game as fast as possible and reports how long each input took
+// Usage: picross_replay <trace file> [repeat count]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "Functions.h"
+#include "Globals.h"
+#include "Input.h"
+#include "Recorder.h"
+
+using namespace globals;
+using namespace std;
+
+using picross::Grid;
+using picross::Trace;
+using picross::TraceEvent;
+
+// The latencies of one kind of message, in nanoseconds
+struct LatencyStats {
+	const char* name;
+	UINT message;
+	vector<double> samples;
+};
+
+// Returns the value at a percentile (as a decimal) of sorted samples
+double percentile(const vector<double>& sorted, double percent) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t index = static_cast<size_t>(percent * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+// Puts the game back to how it was when the recording started
+void reset_game(const Trace& trace) {
+	window_width = trace.window_width;
+	window_height = trace.window_height;
+	game_over = false;
+	last_edit = 0;
+	current_color = 1;
+	vertical_wheel_remainder = 0;
+	horizontal_wheel_remainder = 0;
+
+	board.grid = Grid();
+	board.add_board(NULL, trace.puzzle, SHOW_ANSWER);
+	if (!SHOW_ANSWER) {
+		board.cur_board.clear();
+		board.cur_spaces = 0;
+	}
+	set_random_state(trace.random_state);
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <trace file> [repeat count]\n", argv[0]);
+		return 1;
+	}
+
+	Trace trace;
+	if (!trace.load(argv[1])) {
+		fprintf(stderr, "Could not read the trace %s\n", argv[1]);
+		return 1;
+	}
+
+	int repeat = argc > 2 ? max(atoi(argv[2]), 1) : 1;
+
+	vector<LatencyStats> stats = {
+		{ "left click", WM_LBUTTONDOWN, {} },
+		{ "right click", WM_RBUTTONDOWN, {} },
+		{ "mouse move", WM_MOUSEMOVE, {} },
+		{ "key down", WM_KEYDOWN, {} },
+		{ "mouse wheel", WM_MOUSEWHEEL, {} },
+		{ "mouse h-wheel", WM_MOUSEHWHEEL, {} },
+		{ "resize", WM_SIZE, {} },
+	};
+	for (LatencyStats& stat : stats) {
+		stat.samples.reserve(trace.events.size() * repeat);
+	}
+
+	int puzzles_finished = 0;
+	double total_time = 0;
+
+	for (int run = 0; run < repeat; run++) {
+		reset_game(trace);
+
+		for (const TraceEvent& event : trace.events) {
+			bool was_over = game_over;
+
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			handle_input(NULL, event.message, event.wParam, event.lParam);
+			chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+			double latency = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+			total_time += latency;
+
+			for (LatencyStats& stat : stats) {
+				if (stat.message == event.message) {
+					stat.samples.push_back(latency);
+				}
+			}
+
+			if (game_over && !was_over) {
+				puzzles_finished++;
+			}
+		}
+	}
+
+	double recorded_time = trace.events.empty() ? 0 : trace.events.back().time / 1e6;
+	printf("trace: %s\n", argv[1]);
+	printf("board: %dx%d, window: %dx%d, seed: %llu\n", trace.puzzle.width, trace.puzzle.height, trace.window_width, trace.window_height,
+		static_cast<unsigned long long>(trace.seed));
+	printf("events: %zu x %d runs, recorded over %.2f s, replayed in %.3f ms (%.0f events/s)\n", trace.events.size(), repeat, recorded_time,
+		total_time / 1e6, total_time > 0 ? trace.events.size() * repeat / (total_time / 1e9) : 0.0);
+	printf("puzzles finished: %d, filled spaces at the end: %d\n\n", puzzles_finished, board.cur_spaces);
+
+	printf("%-14s %8s %10s %10s %10s %10s\n", "event", "count", "mean us", "p50 us", "p99 us", "max us");
+	for (LatencyStats& stat : stats) {
+		if (stat.samples.empty()) {
+			continue;
+		}
+
+		sort(stat.samples.begin(), stat.samples.end());
+		double sum = 0;
+		for (double sample : stat.samples) {
+			sum += sample;
+		}
+
+		printf("%-14s %8zu %10.2f %10.2f %10.2f %10.2f\n", stat.name, stat.samples.size(), sum / stat.samples.size() / 1e3,
+			percentile(stat.samples, 0.5) / 1e3, percentile(stat.samples, 0.99) / 1e3, stat.samples.back() / 1e3);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,344 @@
+// Benchmark and self check for the puzzle solver
+// Times line solving a big random puzzle on different numbers of threads, and checks the solver with every phase spread over
+// the threads, against brute force on small random puzzles and against one thread on bigger ones. Building it with
+// -fsanitize=thread checks the threads for races too
+// Usage: picross_solver_bench [--size <spaces>] [--colors <count>] [--percent <filled>] [--threads <list>] [--repeat <count>]
+//                             [--nodes <guesses>] [--check <puzzles>] [--check-large <puzzles>] [--seed <seed>]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Clues.h"
+#include "Functions.h"
+#include "Protocol.h"
+#include "Solver.h"
+#include "TiledBoard.h"
+
+using namespace std;
+
+using picross::ClueSet;
+using picross::SolveLimits;
+using picross::Solver;
+using picross::TiledBoard;
+
+// Brute force tries every board, so the checked puzzles are kept to this many boards
+const int MAX_CHECK_BOARDS = 1 << 16;
+
+// The bigger checked puzzles have sides from just over a block of lines up to this, so their lines take more than one word
+// and their phases are split into more than one block. They are filled enough that line solving does most of the work
+const int MAX_LARGE_CHECK_SIDE = 200;
+const double LARGE_CHECK_PERCENT = 90;
+const int LARGE_CHECK_NODES = 1000;
+
+struct Options {
+	int size = 1000;
+	int colors = 1;
+	// Filled enough that line solving gets through the whole puzzle in a few phases, sparser puzzles get stuck after the first two
+	double percent = 90;
+	vector<int> threads = { 1, 2, 4, 8, 16 };
+	int repeat = 3;
+	int nodes = 1;
+	int check = 0;
+	int check_large = 0;
+	uint64_t seed = 1;
+};
+
+// Reads a list of numbers split by commas, like 1,2,4
+bool parse_list(const char* text, vector<int>& values) {
+	values.clear();
+	while (*text != '\0') {
+		char* end;
+		long value = strtol(text, &end, 10);
+		if (end == text || value < 1 || (*end != ',' && *end != '\0')) {
+			return false;
+		}
+		values.push_back(static_cast<int>(value));
+		text = *end == ',' ? end + 1 : end;
+	}
+	return !values.empty();
+}
+
+// Adds the hints of a line of cells as pairs of run and color, step is 1 for a row and the width for a column
+void line_hints(const int* cells, int length, int step, vector<int>& hints) {
+	hints.clear();
+	for (int i = 0; i < length; i++) {
+		int color = cells[i * step];
+		if (color == 0) {
+			continue;
+		}
+		if (i > 0 && cells[(i - 1) * step] == color) {
+			hints[hints.size() - 2]++;
+		}
+		else {
+			hints.push_back(1);
+			hints.push_back(color);
+		}
+	}
+}
+
+// Finds the hints of every row and then every column of a board
+vector<vector<int>> board_hints(const vector<int>& cells, int width, int height) {
+	vector<vector<int>> lines(height + width);
+	for (int y = 0; y < height; y++) {
+		line_hints(cells.data() + y * width, width, 1, lines[y]);
+	}
+	for (int x = 0; x < width; x++) {
+		line_hints(cells.data() + x, height, width, lines[height + x]);
+	}
+	return lines;
+}
+
+// Returns the colors of the first solution the solver found, a row at a time
+vector<int> solution_cells(const Solver& solver) {
+	vector<int> cells(solver.width * solver.height);
+	for (int i = 0; i < solver.width * solver.height; i++) {
+		cells[i] = solver.solution_color(i % solver.width, i / solver.width);
+	}
+	return cells;
+}
+
+// Counts (up to 2) the boards with the same hints as cells by trying every board
+int brute_force(const vector<int>& cells, int width, int height, int colors) {
+	vector<vector<int>> lines = board_hints(cells, width, height);
+
+	vector<int> board(width * height, 0);
+	vector<int> hints;
+	int found = 0;
+	while (found < 2) {
+		bool same = true;
+		for (int y = 0; y < height && same; y++) {
+			line_hints(board.data() + y * width, width, 1, hints);
+			same = hints == lines[y];
+		}
+		for (int x = 0; x < width && same; x++) {
+			line_hints(board.data() + x, height, width, hints);
+			same = hints == lines[height + x];
+		}
+		found += same;
+
+		// Counts up through every board like a number with colors + 1 digits
+		int i = 0;
+		while (i < width * height && board[i] == colors) {
+			board[i++] = 0;
+		}
+		if (i == width * height) {
+			break;
+		}
+		board[i]++;
+	}
+	return found;
+}
+
+// Checks the solver against brute force on random puzzles for every thread count, returns how many answers were wrong
+int check_solver(const Options& options) {
+	uint64_t random = options.seed;
+	int wrong = 0;
+	vector<Solver> solvers(options.threads.size());
+	for (size_t t = 0; t < solvers.size(); t++) {
+		// Every phase is spread over the threads, no matter how small it is
+		solvers[t].set_threads(options.threads[t], 1);
+	}
+
+	TiledBoard puzzle;
+	ClueSet rows;
+	ClueSet columns;
+	for (int p = 0; p < options.check; p++) {
+		int colors = 1 + random_int(random) % 3;
+		int width;
+		int height;
+		int boards;
+		do {
+			width = 1 + random_int(random) % 4;
+			height = 1 + random_int(random) % 4;
+			boards = 1;
+			for (int i = 0; i < width * height && boards <= MAX_CHECK_BOARDS; i++) {
+				boards *= colors + 1;
+			}
+		} while (boards > MAX_CHECK_BOARDS);
+
+		vector<int> cells(width * height);
+		puzzle.resize(width, height, colors);
+		for (int i = 0; i < width * height; i++) {
+			cells[i] = random_int(random) % (colors + 1);
+			if (cells[i] != 0) {
+				puzzle.set(i % width, i / width, picross::color_state(cells[i]));
+			}
+		}
+		picross::extract_color_clues(puzzle, rows, columns);
+		int expected = brute_force(cells, width, height, colors);
+
+		for (size_t t = 0; t < solvers.size(); t++) {
+			Solver& solver = solvers[t];
+			SolveLimits limits;
+			int found = solver.load(rows, columns) ? solver.solve(2, limits) : 0;
+
+			// The solution has to have the same hints as the puzzle
+			bool matches = found == expected;
+			if (found > 0) {
+				matches = matches && board_hints(solution_cells(solver), width, height) == board_hints(cells, width, height);
+			}
+			if (!matches) {
+				printf("wrong: %dx%d with %d colors on %d threads, found %d instead of %d\n", width, height, colors, options.threads[t], found, expected);
+				wrong++;
+			}
+		}
+	}
+	return wrong;
+}
+
+// Checks the solver on random puzzles too big for brute force, returns how many answers were wrong
+// Every thread count has to give the same answer as solving on one thread, and a solution has to have the same hints as the puzzle
+int check_large_solver(const Options& options) {
+	uint64_t random = options.seed;
+	int wrong = 0;
+	Solver single;
+	vector<Solver> solvers(options.threads.size());
+	for (size_t t = 0; t < solvers.size(); t++) {
+		solvers[t].set_threads(options.threads[t], 1);
+	}
+
+	// Only guesses are limited, so every thread count stops at the same point when a puzzle needs too many
+	SolveLimits limits;
+	limits.nodes = LARGE_CHECK_NODES;
+
+	TiledBoard puzzle;
+	ClueSet rows;
+	ClueSet columns;
+	for (int p = 0; p < options.check_large; p++) {
+		int width = picross::LINE_BLOCK_SIZE + 1 + random_int(random) % (MAX_LARGE_CHECK_SIDE - picross::LINE_BLOCK_SIZE);
+		int height = picross::LINE_BLOCK_SIZE + 1 + random_int(random) % (MAX_LARGE_CHECK_SIDE - picross::LINE_BLOCK_SIZE);
+		int colors = 1 + random_int(random) % 3;
+		picross::generate_puzzle(width, height, LARGE_CHECK_PERCENT / 100, random_int(random), puzzle, colors);
+		picross::extract_color_clues(puzzle, rows, columns);
+
+		vector<int> cells(width * height);
+		for (int i = 0; i < width * height; i++) {
+			cells[i] = picross::state_color(puzzle.get(i % width, i / width));
+		}
+
+		int expected = single.load(rows, columns) ? single.solve(1, limits) : 0;
+		vector<int> expected_solution;
+		if (expected > 0) {
+			expected_solution = solution_cells(single);
+		}
+		if (expected == 0 || (expected > 0 && board_hints(expected_solution, width, height) != board_hints(cells, width, height))) {
+			printf("wrong: %dx%d with %d colors on 1 thread, found %d with the wrong hints\n", width, height, colors, expected);
+			wrong++;
+			continue;
+		}
+
+		for (size_t t = 0; t < solvers.size(); t++) {
+			Solver& solver = solvers[t];
+			int found = solver.load(rows, columns) ? solver.solve(1, limits) : 0;
+			if (found != expected || (found > 0 && solution_cells(solver) != expected_solution)) {
+				printf("wrong: %dx%d with %d colors on %d threads, found %d, 1 thread found %d\n", width, height, colors, options.threads[t], found,
+					expected);
+				wrong++;
+			}
+		}
+	}
+	return wrong;
+}
+
+// Times loading and solving one big puzzle on every thread count, the best of the repeats is kept
+// The speed up is compared to the first thread count in the list
+void time_solver(const Options& options) {
+	TiledBoard puzzle;
+	ClueSet rows;
+	ClueSet columns;
+	picross::generate_puzzle(options.size, options.size, options.percent / 100, options.seed, puzzle, options.colors);
+	picross::extract_color_clues(puzzle, rows, columns);
+
+	SolveLimits limits;
+	limits.nodes = options.nodes;
+	printf("%dx%d puzzle with %d colors, %.0f%% filled, %d guesses\n", options.size, options.size, options.colors, options.percent,
+		options.nodes);
+
+	double first = 0;
+	for (int threads : options.threads) {
+		Solver solver;
+		solver.set_threads(threads);
+		double best = 0;
+		int found = 0;
+		for (int r = 0; r < options.repeat; r++) {
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			solver.load(rows, columns);
+			found = solver.solve(1, limits);
+			double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+			best = r == 0 ? ms : min(best, ms);
+		}
+		if (first == 0) {
+			first = best;
+		}
+		printf("%3d threads: %9.1f ms, %5.2fx speed up, %s\n", threads, best, first / best,
+			found < 0 ? "gave up" : found == 0 ? "no solution" : "solved");
+	}
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	for (int i = 1; i < argc; i++) {
+		bool has_value = i + 1 < argc;
+		bool valid = has_value;
+		if (strcmp(argv[i], "--size") == 0 && has_value) {
+			options.size = min(max(atoi(argv[++i]), 1), picross::MAX_BOARD_SIDE);
+		}
+		else if (strcmp(argv[i], "--colors") == 0 && has_value) {
+			options.colors = min(max(atoi(argv[++i]), 1), picross::MAX_COLORS);
+		}
+		else if (strcmp(argv[i], "--percent") == 0 && has_value) {
+			char* end;
+			options.percent = strtod(argv[++i], &end);
+			valid = end != argv[i] && *end == '\0' && options.percent >= 0 && options.percent <= 100;
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+			valid = parse_list(argv[++i], options.threads);
+		}
+		else if (strcmp(argv[i], "--repeat") == 0 && has_value) {
+			options.repeat = max(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--nodes") == 0 && has_value) {
+			options.nodes = max(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--check") == 0 && has_value) {
+			options.check = max(atoi(argv[++i]), 0);
+		}
+		else if (strcmp(argv[i], "--check-large") == 0 && has_value) {
+			options.check_large = max(atoi(argv[++i]), 0);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+			options.seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else {
+			valid = false;
+		}
+
+		if (!valid) {
+			fprintf(stderr, "Usage: %s [--size <spaces>] [--colors <count>] [--percent <filled>] [--threads <list>] [--repeat <count>]\n"
+				"       [--nodes <guesses>] [--check <puzzles>] [--check-large <puzzles>] [--seed <seed>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (options.check > 0 || options.check_large > 0) {
+		int wrong = 0;
+		if (options.check > 0) {
+			int small_wrong = check_solver(options);
+			printf("checked %d puzzles against brute force on %zu thread counts, %d wrong answers\n", options.check, options.threads.size(), small_wrong);
+			wrong += small_wrong;
+		}
+		if (options.check_large > 0) {
+			int large_wrong = check_large_solver(options);
+			printf("checked %d large puzzles against 1 thread on %zu thread counts, %d wrong answers\n", options.check_large, options.threads.size(),
+				large_wrong);
+			wrong += large_wrong;
+		}
+		return wrong > 0 ? 1 : 0;
+	}
+	time_solver(options);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,580 @@
+// Terminal frontend for picross, it plays the same board as the window but in a terminal so it also works over ssh
+// Usage: picross_tty [width height [colors]]
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Board.h"
+#include "Functions.h"
+#include "Globals.h"
+#include "Input.h"
+#include "ScreenBuffer.h"
+
+using namespace globals;
+using namespace std;
+
+using picross::ScreenBuffer;
+using picross::palette_color;
+
+// The terminal the game is drawn on, only the cells that change between frames are sent to it
+ScreenBuffer screen;
+
+// The board's grid is measured in pixels, so the terminal keeps its own view of the board measured in characters
+// A space on the board is cell_width characters wide and one line tall, wider spaces fit bigger column hints
+int cell_width = 2;
+int first_column = 0;
+int first_row = 0;
+int visible_columns = 1;
+int visible_rows = 1;
+
+// The space for the number hints, hint_width is in characters and hint_height is in lines
+// row_hints_width is how wide the widest row of hints is, which can be more than fits on the screen
+int hint_width = 0;
+int hint_height = 0;
+int row_hints_width = 0;
+
+// The keyboard cursor, clicking a space with the mouse also moves it there
+POINT cursor = { 0, 0 };
+
+// Counting shows how many spaces are between count_start and the cursor. Holding a mouse button counts while dragging,
+// the c key starts and stops counting from the keyboard since terminals don't say when a key is let go
+bool counting = false;
+bool counting_with_mouse = false;
+POINT count_start = { 0, 0 };
+
+// The buttons being held while dragging the mouse, in the same form as the window's mouse messages
+WPARAM drag_buttons = 0;
+POINT last_drag = { -1, -1 };
+
+// Set by signal handlers, the main loop picks them up
+volatile sig_atomic_t terminal_resized = 1;
+volatile sig_atomic_t quit_requested = 0;
+
+// How long to wait for the rest of an escape sequence before an escape on its own is taken as the escape key
+const int ESCAPE_TIMEOUT_MS = 50;
+
+// The hints have to be measured again when there is a new puzzle
+bool needs_layout = true;
+
+termios original_termios;
+
+// Writes everything to the terminal, write can send less than it was given
+void write_all(const string& text) {
+	size_t sent = 0;
+	while (sent < text.size()) {
+		ssize_t result = write(STDOUT_FILENO, text.data() + sent, text.size() - sent);
+		if (result <= 0) {
+			return;
+		}
+		sent += static_cast<size_t>(result);
+	}
+}
+
+// Puts the terminal back to how it was before the game started
+void restore_terminal() {
+	write_all("\x1b[?1006l\x1b[?1002l\x1b[?1000l\x1b[0m\x1b[?25h\x1b[?1049l");
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &original_termios);
+}
+
+void handle_signal(int signal) {
+	if (signal == SIGWINCH) {
+		terminal_resized = 1;
+	}
+	else {
+		quit_requested = 1;
+	}
+}
+
+// Switches the terminal to raw input on its alternate screen with the cursor hidden and mouse reporting turned on
+// Mouse reporting uses the SGR format so that positions past column 223 still work
+bool setup_terminal() {
+	if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) || tcgetattr(STDIN_FILENO, &original_termios) != 0) {
+		return false;
+	}
+
+	termios raw = original_termios;
+	raw.c_lflag &= ~(ECHO | ICANON | IEXTEN);
+	raw.c_iflag &= ~(IXON | ICRNL);
+	raw.c_cc[VMIN] = 0;
+	raw.c_cc[VTIME] = 0;
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+	atexit(restore_terminal);
+
+	struct sigaction action = {};
+	action.sa_handler = handle_signal;
+	sigaction(SIGWINCH, &action, NULL);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	write_all("\x1b[?1049h\x1b[?25l\x1b[?1000h\x1b[?1002h\x1b[?1006h");
+	return true;
+}
+
+// Returns how many characters a number takes up
+int digits(int number) {
+	return static_cast<int>(to_string(number).size());
+}
+
+// Keeps the view within the board
+void clamp_view() {
+	first_column = max(min(first_column, board.width - visible_columns), 0);
+	first_row = max(min(first_row, board.height - visible_rows), 0);
+}
+
+// Scrolls the view just enough to keep the cursor on the screen
+void follow_cursor() {
+	if (cursor.x < first_column) {
+		first_column = cursor.x;
+	}
+	else if (cursor.x >= first_column + visible_columns) {
+		first_column = cursor.x - visible_columns + 1;
+	}
+
+	if (cursor.y < first_row) {
+		first_row = cursor.y;
+	}
+	else if (cursor.y >= first_row + visible_rows) {
+		first_row = cursor.y - visible_rows + 1;
+	}
+	clamp_view();
+}
+
+// Measures the terminal and the number hints to decide how much of the board fits
+// The hints get at most MAX_HINT_FRACTION of the screen like in the window, hints past that are cut off on the far side
+void layout() {
+	winsize size = {};
+	ioctl(STDOUT_FILENO, TIOCGWINSZ, &size);
+	int columns = max(static_cast<int>(size.ws_col), 20);
+	int rows = max(static_cast<int>(size.ws_row), 5);
+
+	if (columns != screen.width || rows != screen.height) {
+		screen.resize(columns, rows);
+	}
+
+	if (needs_layout) {
+		int widest_column_hint = 1;
+		for (int hint : board.column_nums.runs) {
+			widest_column_hint = max(widest_column_hint, digits(hint));
+		}
+		cell_width = max(2, widest_column_hint + 1);
+
+		row_hints_width = 0;
+		for (int row = 0; row < board.height; row++) {
+			int row_width = 0;
+			for (const int* hint = board.row_nums.begin(row); hint != board.row_nums.end(row); ++hint) {
+				row_width += digits(*hint) + 1;
+			}
+			row_hints_width = max(row_hints_width, row_width);
+		}
+		needs_layout = false;
+	}
+
+	// The last line is used for the status bar
+	int board_rows = rows - 1;
+	hint_width = min(row_hints_width, static_cast<int>(columns * MAX_HINT_FRACTION));
+	hint_height = min(board.highest_column_count, static_cast<int>(board_rows * MAX_HINT_FRACTION));
+
+	visible_columns = max(min((columns - hint_width) / cell_width, board.width), 1);
+	visible_rows = max(min(board_rows - hint_height, board.height), 1);
+
+	follow_cursor();
+	screen.invalidate();
+}
+
+// Makes a new puzzle and starts over at the top left
+void new_puzzle() {
+	board.generate_board(NULL, SHOW_ANSWER);
+	game_over = false;
+	counting = false;
+	cursor = POINT{ 0, 0 };
+	first_column = 0;
+	first_row = 0;
+	needs_layout = true;
+	layout();
+}
+
+// Checks if a space is in the counted area between count_start and the cursor
+bool is_counted(int column, int row) {
+	return counting && column >= min(count_start.x, cursor.x) && column <= max(count_start.x, cursor.x) &&
+		row >= min(count_start.y, cursor.y) && row <= max(count_start.y, cursor.y);
+}
+
+// Draws the next frame, only the visible spaces and their hints are drawn so a frame costs the same for any board size
+void draw() {
+	uint8_t background = palette_color(BACKGROUND_COLOR);
+	uint8_t text = palette_color(TEXT_COLOR);
+
+	screen.clear(background);
+
+	if (game_over) {
+		string message = "Puzzle Finished! Click or press a key to start a new puzzle";
+		screen.write(max((screen.width - static_cast<int>(message.size())) / 2, 0), screen.height / 2, message, text, background, true);
+	}
+	else {
+		// Each hint is drawn in the color of its spaces, color 1 uses the normal text color
+		uint8_t fill_colors[picross::MAX_COLORS];
+		for (int color = 0; color < picross::MAX_COLORS; color++) {
+			fill_colors[color] = color == 0 ? text : palette_color(FILL_COLORS[color]);
+		}
+
+		// Column hints are drawn from the board upwards so the ones that get cut off are the farthest away
+		for (int column = 0; column < visible_columns; column++) {
+			int line = first_column + column;
+			int x = hint_width + column * cell_width;
+			int y = hint_height - 1;
+			const int* colors = board.column_nums.line_colors(line);
+			for (int i = board.column_nums.size(line) - 1; i >= 0 && y >= 0; i--, y--) {
+				string number = to_string(board.column_nums.begin(line)[i]);
+				screen.write(x + cell_width - static_cast<int>(number.size()), y, number, fill_colors[colors[i] - 1], background);
+			}
+		}
+
+		// Row hints are drawn from the board leftwards for the same reason
+		for (int row = 0; row < visible_rows; row++) {
+			int line = first_row + row;
+			int x = hint_width;
+			const int* colors = board.row_nums.line_colors(line);
+			for (int i = board.row_nums.size(line) - 1; i >= 0; i--) {
+				string number = to_string(board.row_nums.begin(line)[i]);
+				x -= static_cast<int>(number.size()) + 1;
+				if (x < 0) {
+					break;
+				}
+				screen.write(x, hint_height + row, number, fill_colors[colors[i] - 1], background);
+			}
+		}
+
+		uint8_t shade = palette_color(BLOCK_SHADE_COLOR);
+		uint8_t x_color = palette_color(BLOCK_SPACE_COLOR);
+		uint8_t spacer_color = palette_color(SPACER_COLOR);
+		uint8_t cursor_color = palette_color(CURSOR_COLOR);
+		uint8_t count_color = palette_color(COUNT_COLOR);
+
+		for (int row = 0; row < visible_rows; row++) {
+			int board_row = first_row + row;
+			for (int column = 0; column < visible_columns; column++) {
+				int board_column = first_column + column;
+				int state = board.cur_board.get(board_column, board_row);
+
+				uint8_t cell_background = (board_column / 5 + board_row / 5) % 2 ? shade : background;
+				char glyph = ' ';
+				uint8_t glyph_color = text;
+				int color = picross::state_color(state);
+				switch (state) {
+				case 0:
+					break;
+				case 2:
+					glyph = 'x';
+					glyph_color = x_color;
+					break;
+				case 3:
+					glyph = 'o';
+					glyph_color = spacer_color;
+					break;
+				default:
+					cell_background = palette_color(FILL_COLORS[color - 1]);
+					break;
+				}
+
+				// Filled spaces keep their color under the cursor and in the counted area, the glyph shows they are marked instead
+				if (board_column == cursor.x && board_row == cursor.y) {
+					if (color != 0) {
+						glyph = '#';
+						glyph_color = cursor_color;
+					}
+					else {
+						cell_background = cursor_color;
+					}
+				}
+				else if (is_counted(board_column, board_row)) {
+					if (color != 0) {
+						glyph = '+';
+						glyph_color = count_color;
+					}
+					else {
+						cell_background = count_color;
+					}
+				}
+
+				int x = hint_width + column * cell_width;
+				for (int i = 0; i < cell_width; i++) {
+					screen.put(x + i, hint_height + row, i == cell_width / 2 ? glyph : ' ', glyph_color, cell_background, true);
+				}
+			}
+		}
+	}
+
+	// The status bar shows where the cursor is, the count and the controls
+	string status = " " + to_string(cursor.x + 1) + "," + to_string(cursor.y + 1) + " of " + to_string(board.width) + "x" + to_string(board.height);
+	if (counting) {
+		int count_columns = abs(cursor.x - count_start.x) + 1;
+		int count_rows = abs(cursor.y - count_start.y) + 1;
+		status += "  count: " + (count_columns == 1 || count_rows == 1 ? to_string(count_columns * count_rows) : to_string(count_columns) + "x" + to_string(count_rows));
+	}
+	if (board.correct_board.colors > 1) {
+		status += "  color: " + to_string(min(current_color, board.correct_board.colors)) + " (1-" + to_string(board.correct_board.colors) + " to pick)";
+	}
+	status += "  | arrows/hjkl move, HJKL drag, space fill, x mark, . spacer, c count, r new, q quit";
+	status.resize(max(static_cast<int>(status.size()), screen.width), ' ');
+	screen.write(0, screen.height - 1, status, background, text);
+}
+
+// Moves the cursor, when dragging the space moved onto is changed the same way dragging the mouse over it would
+void move_cursor(int columns, int rows, bool drag) {
+	cursor.x = max(min(cursor.x + columns, static_cast<LONG>(board.width - 1)), 0L);
+	cursor.y = max(min(cursor.y + rows, static_cast<LONG>(board.height - 1)), 0L);
+	follow_cursor();
+
+	if (drag) {
+		click_space(NULL, cursor, MK_LBUTTON, true);
+	}
+}
+
+// Handles a key press
+void handle_key(char key) {
+	if (game_over) {
+		if (key == 'q') {
+			quit_requested = 1;
+		}
+		else {
+			new_puzzle();
+		}
+		return;
+	}
+
+	switch (key) {
+	case 'h': move_cursor(-1, 0, false); break;
+	case 'j': move_cursor(0, 1, false); break;
+	case 'k': move_cursor(0, -1, false); break;
+	case 'l': move_cursor(1, 0, false); break;
+	case 'H': move_cursor(-1, 0, true); break;
+	case 'J': move_cursor(0, 1, true); break;
+	case 'K': move_cursor(0, -1, true); break;
+	case 'L': move_cursor(1, 0, true); break;
+	case ' ':
+	case 'z':
+	case '\r':
+		click_space(NULL, cursor, MK_LBUTTON);
+		break;
+	case 'x':
+		click_space(NULL, cursor, MK_RBUTTON);
+		break;
+	case '.':
+		click_space(NULL, cursor, MK_LBUTTON + MK_SHIFT);
+		break;
+	case 'c':
+		counting = !counting;
+		counting_with_mouse = false;
+		count_start = cursor;
+		break;
+	case 'r':
+	case 'R':
+		new_puzzle();
+		break;
+	case 'q':
+		quit_requested = 1;
+		break;
+	default:
+		// The number keys pick the color that filling uses, like they do in the window
+		if (key >= '1' && key <= '9' && key - '0' <= board.correct_board.colors) {
+			current_color = key - '0';
+		}
+		break;
+	}
+}
+
+// Handles an SGR mouse report, button has the button in its low bits and flags for shift, motion and the wheel above that
+// The position starts at 1 in the top left corner
+void handle_mouse(int button, int x, int y, bool released) {
+	x--;
+	y--;
+
+	// The wheel scrolls the view without moving the cursor, holding shift scrolls sideways
+	if (button & 64) {
+		int direction = (button & 1) ? WHEEL_SCROLL_SPACES : -WHEEL_SCROLL_SPACES;
+		if ((button & 2) || (button & 4)) {
+			first_column += direction;
+		}
+		else {
+			first_row += direction;
+		}
+		clamp_view();
+		return;
+	}
+
+	if (released) {
+		drag_buttons = 0;
+		if (counting_with_mouse) {
+			counting = false;
+			counting_with_mouse = false;
+		}
+		return;
+	}
+
+	bool motion = (button & 32) != 0;
+	if (game_over) {
+		if (!motion) {
+			new_puzzle();
+		}
+		return;
+	}
+
+	bool on_board = x >= hint_width && x < hint_width + visible_columns * cell_width && y >= hint_height && y < hint_height + visible_rows;
+	if (!on_board) {
+		return;
+	}
+	POINT coords = { first_column + (x - hint_width) / cell_width, first_row + (y - hint_height) };
+
+	if (!motion) {
+		// Terminals that pass shift clicks through add MK_SHIFT, the middle button adds a spacer for the ones that don't
+		switch (button & 3) {
+		case 0: drag_buttons = MK_LBUTTON; break;
+		case 1: drag_buttons = MK_LBUTTON + MK_SHIFT; break;
+		case 2: drag_buttons = MK_RBUTTON; break;
+		default: return;
+		}
+		if ((button & 4) && drag_buttons != MK_LBUTTON + MK_SHIFT) {
+			drag_buttons += MK_SHIFT;
+		}
+
+		cursor = coords;
+		last_drag = coords;
+		counting = true;
+		counting_with_mouse = true;
+		count_start = coords;
+		click_space(NULL, coords, drag_buttons);
+	}
+	else if (drag_buttons != 0 && (coords.x != last_drag.x || coords.y != last_drag.y)) {
+		cursor = coords;
+		last_drag = coords;
+		click_space(NULL, coords, drag_buttons, true);
+	}
+}
+
+// Reads the keys and escape sequences out of the input, anything cut off part way is left for the next read
+void handle_input_bytes(string& input) {
+	size_t i = 0;
+	while (i < input.size()) {
+		if (input[i] != '\x1b') {
+			handle_key(input[i]);
+			i++;
+			continue;
+		}
+
+		// An escape at the end of the input could be the start of a sequence that was split between reads,
+		// so it is left for the main loop to decide once it has waited for more bytes
+		if (i + 1 == input.size()) {
+			break;
+		}
+
+		if (input[i + 1] != '[' && input[i + 1] != 'O') {
+			i++;
+			continue;
+		}
+
+		// Control sequences end with a byte from @ to ~
+		size_t end = i + 2;
+		while (end < input.size() && (input[end] < '@' || input[end] > '~')) {
+			end++;
+		}
+		if (end == input.size()) {
+			// Unfinished sequences wait for the rest of their bytes, unless they are too long to be real
+			if (input.size() - i > 32) {
+				i = input.size();
+			}
+			break;
+		}
+
+		string parameters = input.substr(i + 2, end - i - 2);
+		char final_byte = input[end];
+		i = end + 1;
+
+		if (!parameters.empty() && parameters[0] == '<' && (final_byte == 'M' || final_byte == 'm')) {
+			int button = 0;
+			int x = 0;
+			int y = 0;
+			if (sscanf(parameters.c_str() + 1, "%d;%d;%d", &button, &x, &y) == 3) {
+				handle_mouse(button, x, y, final_byte == 'm');
+			}
+			continue;
+		}
+
+		// Shifted arrows drag like HJKL
+		bool shifted = parameters.find(";2") != string::npos;
+		switch (final_byte) {
+		case 'A': handle_key(shifted ? 'K' : 'k'); break;
+		case 'B': handle_key(shifted ? 'J' : 'j'); break;
+		case 'C': handle_key(shifted ? 'L' : 'l'); break;
+		case 'D': handle_key(shifted ? 'H' : 'h'); break;
+		case '~':
+			// Page up and page down scroll a whole screen of rows
+			if (parameters == "5") {
+				move_cursor(0, -visible_rows, false);
+			}
+			else if (parameters == "6") {
+				move_cursor(0, visible_rows, false);
+			}
+			break;
+		}
+	}
+	input.erase(0, i);
+}
+
+int main(int argc, char* argv[]) {
+	seed_random(static_cast<uint64_t>(time(NULL)));
+
+	if (argc >= 3) {
+		int colors = argc >= 4 ? min(max(atoi(argv[3]), 1), picross::MAX_COLORS) : PUZZLE_COLORS;
+		board.resize(min(max(atoi(argv[1]), 1), picross::MAX_BOARD_SIDE), min(max(atoi(argv[2]), 1), picross::MAX_BOARD_SIDE), colors);
+	}
+	board.generate_board(NULL, SHOW_ANSWER);
+
+	if (!setup_terminal()) {
+		fprintf(stderr, "picross_tty needs to be run in a terminal\n");
+		return 1;
+	}
+
+	string input;
+	char buffer[4096];
+
+	// This is the main loop, each frame only sends the cells that changed
+	while (running && !quit_requested) {
+		if (terminal_resized) {
+			terminal_resized = 0;
+			layout();
+		}
+
+		draw();
+		write_all(screen.present());
+
+		// Waits for input, a resize interrupts the wait
+		// An escape that nothing followed within ESCAPE_TIMEOUT_MS is the escape key, which quits like it does in the window
+		bool lone_escape = input == "\x1b";
+		pollfd input_poll = { STDIN_FILENO, POLLIN, 0 };
+		int ready = poll(&input_poll, 1, lone_escape ? ESCAPE_TIMEOUT_MS : -1);
+		if (ready == 0 && lone_escape) {
+			quit_requested = 1;
+			continue;
+		}
+		if (ready <= 0) {
+			continue;
+		}
+
+		ssize_t count;
+		while ((count = read(STDIN_FILENO, buffer, sizeof(buffer))) > 0) {
+			input.append(buffer, static_cast<size_t>(count));
+		}
+		handle_input_bytes(input);
+	}
+
+	return 0;
+}
\ No newline at end of file
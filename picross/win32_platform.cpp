@@ -2,18 +2,26 @@
 // Add counter when you drag your mouse while holding a button
 
 #include <windows.h>
+#include <algorithm>
+#include <ctime>
 #include <fstream>
 #include <string>
 
 #include "Globals.h"
 #include "Board.h"
+#include "Functions.h"
+#include "Input.h"
+#include "Recorder.h"
 
 using namespace globals;
 using namespace std;
 
 using picross::Board;
+using picross::Recorder;
+using picross::TiledBoard;
 
-Board board;
+// Records the session when the program is started with --record <file>
+Recorder recorder;
 
 // Checks if a file exists
 bool file_exists(const string& name) {
@@ -50,107 +58,9 @@ void draw_window_objects(HWND hwnd, bool clearscreen=true) {
 	EndPaint(hwnd, &ps);
 }
 
-// This function handles any click related actions by the user. If the user is holding a click button and dragging, mouse_moving is true
-// Left clicking adds or removes a space or an x
-// Right clicking adds or removes an x or a space
-// Shift clicking adds a spacer
-// Both left and right click will directly override a spacer with the corresponding element
-// Clicking and dragging will add or remove the corresponding space to each grid hovered over
-// If the space was removed, it will remove all elements on dragging, x's do not override spaces, spaces don't override x's, spacers will be overridden
-void handle_click(HWND hwnd, WPARAM wParam, LPARAM lParam, bool mouse_moving = false) {
-	if (game_over && !mouse_moving) {
-		// Create a new board since the user clicked on the game over screen
-		board.generate_board(hwnd, SHOW_ANSWER);
-		game_over = false;
-	}
-	else {
-		bool shiftClick = wParam == MK_LBUTTON + MK_SHIFT || wParam == MK_RBUTTON + MK_SHIFT;
-		bool lClick = wParam == MK_LBUTTON && !shiftClick;
-		bool rClick = wParam == MK_RBUTTON && !shiftClick;
-		POINT pt;
-		pt.x = LOWORD(lParam);
-		pt.y = HIWORD(lParam);
-
-		if (board.pt_on_board(pt)) {
-			POINT coords = board.point_to_coords(pt);
-
-			switch (board.cur_board[coords.x][coords.y]) {
-			case 0:
-				if (mouse_moving) {
-					board.set_board_space(hwnd, coords, last_edit);
-				}
-				else {
-					if (lClick) {
-						board.set_board_space(hwnd, coords, 1);
-					}
-					else if (rClick) {
-						board.set_board_space(hwnd, coords, 2);
-					}
-					else if (shiftClick) {
-						board.set_board_space(hwnd, coords, 3);
-					}
-				}
-				break;
-
-			case 1: 
-				if (mouse_moving) {
-					if (last_edit == 0) {
-						board.set_board_space(hwnd, coords, last_edit);
-					}
-				}
-				else {
-					if (lClick || rClick) {
-						board.set_board_space(hwnd, coords, 0);
-					}
-				}
-				break;
-			
-
-			case 2: 
-				if (mouse_moving) {
-					if (last_edit == 0) {
-						board.set_board_space(hwnd, coords, last_edit);
-					}
-				}
-				else {
-					if (lClick || rClick) {
-						board.set_board_space(hwnd, coords, 0);
-					}
-				}
-				break;
-			
-			case 3: 
-				if (mouse_moving) {
-					if (last_edit != 3) {
-						board.set_board_space(hwnd, coords, last_edit);
-					}
-				}
-				else {
-					if (lClick) {
-						board.set_board_space(hwnd, coords, 1);
-					}
-					else if (rClick) {
-						board.set_board_space(hwnd, coords, 2);
-					}
-					else if (shiftClick) {
-						board.set_board_space(hwnd, coords, 0);
-					}
-				}
-				break;
-			}
-
-			if (board.cur_spaces == board.correct_spaces) {
-				game_over = board.check_correct(hwnd);
-			}
-		}
-	}
-}
-
 // Windows message handling function
 // This is the function that handles all of the user inputs (and messages that result from those inputs)
 LRESULT CALLBACK window_callback(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
-	LRESULT result = 0;
-
 	switch (uMsg) 
 	{
 	case WM_CLOSE:
@@ -158,60 +68,42 @@ LRESULT CALLBACK window_callback(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lPa
 		return 0;
 		
 	case WM_DESTROY:
+		recorder.stop();
 		running = false;
 		PostQuitMessage(0);
 		return 0;
 
-	case WM_LBUTTONDOWN:
-		handle_click(hwnd, wParam, lParam);
-		SendMessage(hwnd, WM_PAINT, NULL, NULL);
+	case WM_PAINT: 
+		draw_window_objects(hwnd, true);
 		return 0;
 
-	case WM_RBUTTONDOWN:
-		handle_click(hwnd, wParam, lParam);
-		SendMessage(hwnd, WM_PAINT, NULL, NULL);
-		return 0;
+	// The mouse wheel gives its position in screen coordinates, it is converted to the window's coordinates like every other mouse message
+	case WM_MOUSEWHEEL: {
+		POINT pt;
+		pt.x = GET_X_LPARAM(lParam);
+		pt.y = GET_Y_LPARAM(lParam);
+		ScreenToClient(hwnd, &pt);
+		lParam = MAKELPARAM(pt.x, pt.y);
+		break;
+	}
+	}
 
-	case WM_KEYDOWN: 
-		// 0x52 is the R key
-		// Resets the board, since this program isn't smart enough to tell if a board is completable, I have increased the amount of correct spaces
-		// Increasing the spaces has made it much easier but the majority of games should be completable, however, if necessary the user can reset it
-		if (wParam == 0x52) {
-			board.generate_board(hwnd, SHOW_ANSWER);
+	// User inputs are recorded before they are handled so that the trace has them in the order they happened
+	if (is_input_message(uMsg)) {
+		if (recorder.recording()) {
+			recorder.record(uMsg, wParam, lParam);
 		}
-		if (wParam == VK_ESCAPE) {
+
+		if (uMsg == WM_KEYDOWN && wParam == VK_ESCAPE) {
 			DestroyWindow(hwnd);
 		}
-		return 0;
-
-	// Used to handle mouse dragging
-	case WM_MOUSEMOVE: 
-		if (wParam == MK_LBUTTON || wParam == MK_RBUTTON || wParam == MK_LBUTTON + MK_SHIFT || wParam == MK_RBUTTON + MK_SHIFT) {
-			POINT pt; 
-			pt.x = LOWORD(lParam);
-			pt.y = HIWORD(lParam);
-			if (board.pt_on_board(pt)) {
-				handle_click(hwnd, wParam, lParam, true);
-				SendMessage(hwnd, WM_PAINT, NULL, NULL);
-			}
+		else if (handle_input(hwnd, uMsg, wParam, lParam)) {
+			SendMessage(hwnd, WM_PAINT, NULL, NULL);
 		}
 		return 0;
-
-	case WM_SIZE:
-		window_width = LOWORD(lParam);
-		window_height = HIWORD(lParam);
-
-		board.update(hwnd);
-		[[fallthrough]];
-
-	case WM_PAINT: 
-		draw_window_objects(hwnd, true);
-		return 0;
-
-	default: 
-		result = DefWindowProc(hwnd, uMsg, wParam, lParam);
 	}
-	return result;
+
+	return DefWindowProc(hwnd, uMsg, wParam, lParam);
 }
 
 // This is the main function which is run first
@@ -247,9 +139,11 @@ int CALLBACK WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		return 0;
 	}
 
-	// Randomizes the seed
+	// Randomizes the seed, the seed is kept so that it can be recorded
+	uint64_t seed = RANDOM_PUZZLES ? static_cast<uint64_t>(time(NULL)) : 0;
+	seed_random(seed);
+
 	if (RANDOM_PUZZLES) {
-		srand(time(NULL));
 		board.generate_board(hwnd, SHOW_ANSWER);
 	}
 	// If a bitstring file exists, it will use that to populate the picross board
@@ -258,21 +152,50 @@ int CALLBACK WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		ifstream bitFile ("bitstring.txt");
 
 		// Creates a new board to add to the original board
-		int new_board[BOARD_WIDTH][BOARD_HEIGHT];
+		// Each digit is the color of a space, so the board needs as many colors as the highest digit
+		// A file that is too short or has anything other than the digits 0 to MAX_COLORS isn't used, a random puzzle is made instead
+		bool valid = false;
+		int colors = 1;
 		if (bitFile.is_open())
 		{
 			getline(bitFile, line);
 			bitFile.close();
+
+			valid = line.size() >= BOARD_SIZE;
+			for (int i = 0; i < BOARD_SIZE && valid; i++) {
+				int digit = line[i] - '0';
+				valid = digit >= 0 && digit <= picross::MAX_COLORS;
+				colors = max(colors, digit);
+			}
+		}
+
+		if (valid) {
+			TiledBoard new_board(BOARD_WIDTH, BOARD_HEIGHT, colors);
 			
 			for(int i = 0; i < BOARD_SIZE;i++)
 			{
-				new_board[i % BOARD_WIDTH][i / BOARD_HEIGHT] = (int) line[i] - '0';
+				int color = line[i] - '0';
+				if (color > 0) {
+					new_board.set(i % BOARD_WIDTH, i / BOARD_WIDTH, picross::color_state(color));
+				}
 			}
 			board.add_board(hwnd, new_board, SHOW_ANSWER);
 		}
 		else board.generate_board(hwnd, SHOW_ANSWER);
 	}
 
+	// Recording starts once the puzzle is ready, the window size from showing the window is the first thing recorded
+	const string RECORD_ARGUMENT = "--record ";
+	string arguments = lpCmdLine;
+	if (arguments.rfind(RECORD_ARGUMENT, 0) == 0) {
+		string trace_path = arguments.substr(RECORD_ARGUMENT.size());
+		trace_path.erase(remove(trace_path.begin(), trace_path.end(), '"'), trace_path.end());
+		if (!recorder.start(trace_path, seed, board)) {
+			MessageBoxA(hwnd, ("Can't record to " + trace_path + ", the file couldn't be opened or the board is too big to replay").c_str(), "Picross", MB_OK | MB_ICONERROR);
+			return 1;
+		}
+	}
+
 	ShowWindow(hwnd, nCmdShow);
 
 	// This is the main loop of the program, it handles inputs